@@ -1,232 +1,350 @@
-#include "info.hpp"
-#include "algorithm"
-
-Info::Info(const char* name_) : Widget(name_)
-{
-    AutoScroll = true;
-    Clear();
-}
-
-void Info::Clear()
-{
-    Buf.clear();
-    LineOffsets.clear();
-    LineOffsets.push_back(0);
-}
-
-void Info::vAddLog(const char* fmt, va_list args)
-{
-    int old_size = Buf.size();
-    Buf.appendfv(fmt, args);
-    for (int new_size = Buf.size(); old_size < new_size; old_size++)
-        if (Buf[old_size] == '\n')
-            LineOffsets.push_back(old_size + 1);
-}
-
-void Info::AddLog(const char* fmt, ...)
-{
-    va_list args;
-    int old_size = Buf.size();
-    va_start(args, fmt);
-    Buf.appendfv(fmt, args);
-    va_end(args);
-    for (int new_size = Buf.size(); old_size < new_size; old_size++)
-        if (Buf[old_size] == '\n')
-            LineOffsets.push_back(old_size + 1);
-}
-
-void Info::DrawLog(){
-    // Options menu
-    if (ImGui::BeginPopup("Options"))
-    {
-        ImGui::Checkbox("Auto-scroll", &AutoScroll);
-        ImGui::EndPopup();
-    }
-
-    // Main window
-    if (ImGui::Button("Options"))
-        ImGui::OpenPopup("Options");
-    ImGui::SameLine();
-    bool clear = ImGui::Button("Clear");
-    ImGui::SameLine();
-    bool copy = ImGui::Button("Copy");
-    ImGui::SameLine();
-    Filter.Draw("Filter", -100.0f);
-
-    ImGui::Separator();
-
-    if (ImGui::BeginChild("scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar))
-    {
-        if (clear)
-            Clear();
-        if (copy)
-            ImGui::LogToClipboard();
-
-        ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
-        const char* buf = Buf.begin();
-        const char* buf_end = Buf.end();
-        if (Filter.IsActive())
-        {
-            for (int line_no = 0; line_no < LineOffsets.Size; line_no++)
-            {
-                const char* line_start = buf + LineOffsets[line_no];
-                const char* line_end = (line_no + 1 < LineOffsets.Size) ? (buf + LineOffsets[line_no + 1] - 1) : buf_end;
-                if (Filter.PassFilter(line_start, line_end))
-                    ImGui::TextUnformatted(line_start, line_end);
-            }
-        }
-        else
-        {
-            ImGuiListClipper clipper;
-            clipper.Begin(LineOffsets.Size);
-            while (clipper.Step())
-            {
-                for (int line_no = clipper.DisplayStart; line_no < clipper.DisplayEnd; line_no++)
-                {
-                    const char* line_start = buf + LineOffsets[line_no];
-                    const char* line_end = (line_no + 1 < LineOffsets.Size) ? (buf + LineOffsets[line_no + 1] - 1) : buf_end;
-                    ImGui::TextUnformatted(line_start, line_end);
-                }
-            }
-            clipper.End();
-        }
-        ImGui::PopStyleVar();
-
-        if (AutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
-            ImGui::SetScrollHereY(1.0f);
-    }
-    ImGui::EndChild();
-}
-
-void Info::SetProfilerData(core::DebugInfo *data_){
-    data = data_;
-}
-
-void Info::DrawProfiler(){
-    ImGuiTreeNodeFlags flags;
-
-    double avg_ms;
-
-    {
-        if (ms_plot.size() >= max_samples) {
-            accum_ms-=ms_plot[0];
-            ms_plot.erase(ms_plot.begin());
-        }
-        ms_plot.push_back(data->end_ms - data->start_ms);
-        accum_ms+=data->end_ms - data->start_ms;
-
-        avg_ms = accum_ms/ms_plot.size();
-
-        max_ms = *std::max_element(ms_plot.begin(), ms_plot.end());
-
-        ImGui::PlotLines("", ms_plot.data(), ms_plot.size(), 0, nullptr, 0, max_ms, ImVec2(0, 80));
-    }
-
-    ImGui::Text("Average FPS: %2f", (1000.0/(avg_ms)));
-    ImGui::Text("Average ms/f: %2f", (avg_ms));
-
-    ImGui::Separator();
-
-    ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(150,100,200,255));
-    flags = ImGuiTreeNodeFlags_DefaultOpen;
-    if (ImGui::TreeNodeEx("GPU", flags))
-    {
-        double gpu_avg_ms;
-        {
-            if (gpu_ms_plot.size() >= max_samples) {
-                gpu_accum_ms-=gpu_ms_plot[0];
-                gpu_ms_plot.erase(gpu_ms_plot.begin());
-            }
-            gpu_ms_plot.push_back(data->gpu_end_ms - data->gpu_start_ms);
-            gpu_accum_ms+=data->gpu_end_ms - data->gpu_start_ms;
-
-            gpu_avg_ms = gpu_accum_ms/gpu_ms_plot.size();
-
-            ImGui::PlotLines("", gpu_ms_plot.data(), gpu_ms_plot.size(), 0, nullptr, 0, max_ms, ImVec2(0, 80));
-        }
-
-        ImGui::Text("%i%%", (int)((gpu_avg_ms / avg_ms) * 100.0));
-        ImGui::Text("Average ms/f: %2f", gpu_avg_ms);
-
-        flags = ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_Leaf;
-        char label[128];
-        snprintf(label, sizeof(label), "shader recompilation: %.2f", (data->gpu_shaderCompilation_ms - data->gpu_start_ms));
-        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
-
-        snprintf(label, sizeof(label), "framebuffer resize: %2f", (data->gpu_framebufferResize_ms - data->gpu_shaderCompilation_ms));
-        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
-
-        snprintf(label, sizeof(label), "pass1: %2f", (data->gpu_pass1_ms - data->gpu_framebufferResize_ms));
-        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
-
-        snprintf(label, sizeof(label), "pass2: %2f", (data->gpu_pass2_ms - data->gpu_pass1_ms));
-        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
-
-        snprintf(label, sizeof(label), "pass3: %2f", (data->gpu_pass3_ms - data->gpu_pass2_ms));
-        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
-
-        snprintf(label, sizeof(label), "pass4: %2f", (data->gpu_end_ms - data->gpu_pass3_ms));
-        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
-
-        ImGui::TreePop();
-    }  
-    ImGui::PopStyleColor();
-    ImGui::Separator();
-
-    ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(200,200,150,255));
-    flags = ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_Leaf;
-    if (ImGui::TreeNodeEx("CPU", flags))
-    {
-        double cpu_avg_ms;
-        {
-            if (cpu_ms_plot.size() >= max_samples) {
-                cpu_accum_ms-=cpu_ms_plot[0];
-                cpu_ms_plot.erase(cpu_ms_plot.begin());
-            }
-            cpu_ms_plot.push_back(data->cpu_end_ms - data->cpu_start_ms);
-            cpu_accum_ms+=data->cpu_end_ms - data->cpu_start_ms;
-
-            cpu_avg_ms = cpu_accum_ms/cpu_ms_plot.size();
-
-            ImGui::PlotLines("", cpu_ms_plot.data(), cpu_ms_plot.size(), 0, nullptr, 0, max_ms, ImVec2(0, 80));
-        }
-
-        ImGui::Text("%i%%", (int)((cpu_avg_ms / avg_ms) * 100.0));
-        ImGui::Text("ms/f: %2f", cpu_avg_ms);
-
-        ImGui::TreePop();
-    }  
-    ImGui::PopStyleColor();
-}
-
-void Info::DrawMemUsage(){
-    ImGui::Text("volume memory: %f mb", (double)data->scene_mem / (1000.0*1000.0));
-    ImGui::Text("volume capacity: %f mb", (double)data->scene_capacity / (1000.0*1000.0));
-    ImGui::Text("lBuffer memory: %f mb", (double)data->lBuffer_mem / (1000.0*1000.0));
-}
-
-void Info::DrawSceneData(){
-    ImGui::Text("num voxels: %u", data->voxels_num);
-    ImGui::Text("cam position:  \n     x:%f \n     y:%f \n     z:%f", data->cam_position.x, data->cam_position.y, data->cam_position.z);
-    ImGui::Text("cam direction: \n     x:%f \n     y:%f \n     z:%f", data->cam_direction.x, data->cam_direction.y, data->cam_direction.z);
-}
-
-void Info::Draw()
-{
-    if (!ImGui::Begin(name))
-    {
-        ImGui::End();
-        return;
-    }
-
-    if(ImGui::CollapsingHeader("profiler", ImGuiTreeNodeFlags_DefaultOpen))
-        DrawProfiler();
-    if(ImGui::CollapsingHeader("scene data"))
-        DrawSceneData();
-    if(ImGui::CollapsingHeader("memory usage"))
-        DrawMemUsage();
-    if(ImGui::CollapsingHeader("logger", ImGuiTreeNodeFlags_DefaultOpen))
-        DrawLog();
-
-    ImGui::End();
+#include "info.hpp"
+#include "algorithm"
+#include <cfloat>
+
+Info::Info(const char* name_) : Widget(name_)
+{
+    AutoScroll = true;
+    Clear();
+}
+
+void Info::Clear()
+{
+    Buf.clear();
+    LineOffsets.clear();
+    LineOffsets.push_back(0);
+}
+
+void Info::vAddLog(const char* fmt, va_list args)
+{
+    int old_size = Buf.size();
+    Buf.appendfv(fmt, args);
+    for (int new_size = Buf.size(); old_size < new_size; old_size++)
+        if (Buf[old_size] == '\n')
+            LineOffsets.push_back(old_size + 1);
+}
+
+void Info::AddLog(const char* fmt, ...)
+{
+    va_list args;
+    int old_size = Buf.size();
+    va_start(args, fmt);
+    Buf.appendfv(fmt, args);
+    va_end(args);
+    for (int new_size = Buf.size(); old_size < new_size; old_size++)
+        if (Buf[old_size] == '\n')
+            LineOffsets.push_back(old_size + 1);
+}
+
+void Info::DrawLog(){
+    // Options menu
+    if (ImGui::BeginPopup("Options"))
+    {
+        ImGui::Checkbox("Auto-scroll", &AutoScroll);
+        ImGui::EndPopup();
+    }
+
+    // Main window
+    if (ImGui::Button("Options"))
+        ImGui::OpenPopup("Options");
+    ImGui::SameLine();
+    bool clear = ImGui::Button("Clear");
+    ImGui::SameLine();
+    bool copy = ImGui::Button("Copy");
+    ImGui::SameLine();
+    Filter.Draw("Filter", -100.0f);
+
+    ImGui::Separator();
+
+    if (ImGui::BeginChild("scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar))
+    {
+        if (clear)
+            Clear();
+        if (copy)
+            ImGui::LogToClipboard();
+
+        ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
+        const char* buf = Buf.begin();
+        const char* buf_end = Buf.end();
+        if (Filter.IsActive())
+        {
+            for (int line_no = 0; line_no < LineOffsets.Size; line_no++)
+            {
+                const char* line_start = buf + LineOffsets[line_no];
+                const char* line_end = (line_no + 1 < LineOffsets.Size) ? (buf + LineOffsets[line_no + 1] - 1) : buf_end;
+                if (Filter.PassFilter(line_start, line_end))
+                    ImGui::TextUnformatted(line_start, line_end);
+            }
+        }
+        else
+        {
+            ImGuiListClipper clipper;
+            clipper.Begin(LineOffsets.Size);
+            while (clipper.Step())
+            {
+                for (int line_no = clipper.DisplayStart; line_no < clipper.DisplayEnd; line_no++)
+                {
+                    const char* line_start = buf + LineOffsets[line_no];
+                    const char* line_end = (line_no + 1 < LineOffsets.Size) ? (buf + LineOffsets[line_no + 1] - 1) : buf_end;
+                    ImGui::TextUnformatted(line_start, line_end);
+                }
+            }
+            clipper.End();
+        }
+        ImGui::PopStyleVar();
+
+        if (AutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+            ImGui::SetScrollHereY(1.0f);
+    }
+    ImGui::EndChild();
+}
+
+void Info::SetProfilerData(core::DebugInfo *data_){
+    data = data_;
+}
+
+void Info::DrawProfiler(){
+    ImGuiTreeNodeFlags flags;
+
+    double avg_ms;
+
+    {
+        if (ms_plot.size() >= max_samples) {
+            accum_ms-=ms_plot[0];
+            ms_plot.erase(ms_plot.begin());
+        }
+        ms_plot.push_back(data->end_ms - data->start_ms);
+        accum_ms+=data->end_ms - data->start_ms;
+
+        avg_ms = accum_ms/ms_plot.size();
+
+        max_ms = *std::max_element(ms_plot.begin(), ms_plot.end());
+
+        ImGui::PlotLines("", ms_plot.data(), ms_plot.size(), 0, nullptr, 0, max_ms, ImVec2(0, 80));
+    }
+
+    ImGui::Text("Average FPS: %2f", (1000.0/(avg_ms)));
+    ImGui::Text("Average ms/f: %2f", (avg_ms));
+    ImGui::Text("progressive: %u samples, %.1f%% converged%s", data->progressive_samples, data->progressive_convergence * 100.0f, data->converged ? " (idle)" : "");
+
+    ImGui::Separator();
+
+    ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(150,100,200,255));
+    flags = ImGuiTreeNodeFlags_DefaultOpen;
+    if (ImGui::TreeNodeEx("GPU", flags))
+    {
+        double gpu_avg_ms;
+        {
+            if (gpu_ms_plot.size() >= max_samples) {
+                gpu_accum_ms-=gpu_ms_plot[0];
+                gpu_ms_plot.erase(gpu_ms_plot.begin());
+            }
+            gpu_ms_plot.push_back(data->gpu_end_ms - data->gpu_start_ms);
+            gpu_accum_ms+=data->gpu_end_ms - data->gpu_start_ms;
+
+            gpu_avg_ms = gpu_accum_ms/gpu_ms_plot.size();
+
+            ImGui::PlotLines("", gpu_ms_plot.data(), gpu_ms_plot.size(), 0, nullptr, 0, max_ms, ImVec2(0, 80));
+        }
+
+        ImGui::Text("%i%%", (int)((gpu_avg_ms / avg_ms) * 100.0));
+        ImGui::Text("Average ms/f: %2f", gpu_avg_ms);
+
+        flags = ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_Leaf;
+        char label[128];
+        snprintf(label, sizeof(label), "shader recompilation: %.2f", (data->gpu_shaderCompilation_ms - data->gpu_start_ms));
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "framebuffer resize: %2f", (data->gpu_framebufferResize_ms - data->gpu_shaderCompilation_ms));
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "pass1: %2f", (data->gpu_pass1_ms - data->gpu_framebufferResize_ms));
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "pass2: %2f", (data->gpu_pass2_ms - data->gpu_pass1_ms));
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "pass3: %2f", (data->gpu_pass3_ms - data->gpu_pass2_ms));
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "rayPass (query): %2f", data->gpu_ray_query_ms);
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "octree fetches per ray: %.2f (%s ropes)",
+            data->traversal_rays == 0 ? 0.0 : (double)data->traversal_fetches / (double)data->traversal_rays, data->traversal_ropes ? "with" : "without");
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "beamPass (query): %2f", data->gpu_beam_query_ms);
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "conePass (query): %2f", data->gpu_cone_query_ms);
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "accumPass (query): %2f", data->gpu_accum_query_ms);
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "avgPass (query): %2f", data->gpu_avg_query_ms);
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "progressive: %2f", (data->gpu_progressive_ms - data->gpu_pass3_ms));
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        snprintf(label, sizeof(label), "pass4: %2f", (data->gpu_end_ms - data->gpu_progressive_ms));
+        if (ImGui::TreeNodeEx(label, flags)) ImGui::TreePop();
+
+        ImGui::TreePop();
+    }  
+    ImGui::PopStyleColor();
+    ImGui::Separator();
+
+    ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(200,200,150,255));
+    flags = ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_Leaf;
+    if (ImGui::TreeNodeEx("CPU", flags))
+    {
+        double cpu_avg_ms;
+        {
+            if (cpu_ms_plot.size() >= max_samples) {
+                cpu_accum_ms-=cpu_ms_plot[0];
+                cpu_ms_plot.erase(cpu_ms_plot.begin());
+            }
+            cpu_ms_plot.push_back(data->cpu_end_ms - data->cpu_start_ms);
+            cpu_accum_ms+=data->cpu_end_ms - data->cpu_start_ms;
+
+            cpu_avg_ms = cpu_accum_ms/cpu_ms_plot.size();
+
+            ImGui::PlotLines("", cpu_ms_plot.data(), cpu_ms_plot.size(), 0, nullptr, 0, max_ms, ImVec2(0, 80));
+        }
+
+        ImGui::Text("%i%%", (int)((cpu_avg_ms / avg_ms) * 100.0));
+        ImGui::Text("ms/f: %2f", cpu_avg_ms);
+
+        bool zones = Profiler::enabled;
+        if(ImGui::Checkbox("zones (F9 saves a trace)", &zones))
+            Profiler::enabled = zones;
+
+        //scoped zones, summed over every thread
+        for(const std::pair<const char*, float> &zone : data->zone_ms){
+            size_t i = 0;
+            while(i < zone_plots.size() && zone_plots[i].first != zone.first)
+                i++;
+            if(i == zone_plots.size())
+                zone_plots.push_back({zone.first, {}});
+
+            std::vector<float> &plot = zone_plots[i].second;
+            if (plot.size() >= (size_t)max_samples)
+                plot.erase(plot.begin());
+            plot.push_back(zone.second);
+
+            char zoneLabel[128];
+            snprintf(zoneLabel, sizeof(zoneLabel), "%s: %2f", zone.first, zone.second);
+            ImGui::PlotLines(zoneLabel, plot.data(), plot.size(), 0, nullptr, 0, max_ms, ImVec2(0, 40));
+        }
+
+        ImGui::TreePop();
+    }  
+    ImGui::PopStyleColor();
+}
+
+void Info::DrawMemUsage(){
+    ImGui::Text("volume memory: %f mb", (double)data->scene_mem / (1000.0*1000.0));
+    ImGui::Text("volume capacity: %f mb", (double)data->scene_capacity / (1000.0*1000.0));
+    ImGui::Text("lBuffer memory: %f mb", (double)data->lBuffer_mem / (1000.0*1000.0));
+    ImGui::Text("gBuffer memory: %f mb (RGBA32F layout: %f mb)", (double)data->gBuffer_mem / (1000.0*1000.0), (double)data->gBuffer_mem_rgba32f / (1000.0*1000.0));
+    ImGui::Text("gBuffer without aliasing: %f mb", (double)data->gBuffer_mem_unaliased / (1000.0*1000.0));
+    ImGui::Text("render graph: %u passes, %u culled", data->graph_passes, data->graph_culled);
+    ImGui::Text("barriers: %u (blanket per pass: %u)", data->graph_barriers, data->graph_barriers_blanket);
+    ImGui::Text("lBuffer entries: %u / %u (%.1f%%)", data->lBuffer_occupied, data->lBuffer_capacity,
+        data->lBuffer_capacity == 0 ? 0.0 : (double)data->lBuffer_occupied / (double)data->lBuffer_capacity * 100.0);
+
+    uint32_t resolved = data->lBuffer_lookups - data->lBuffer_failures;
+    ImGui::Text("lBuffer lookups: %u, claims: %u", data->lBuffer_lookups, data->lBuffer_claims);
+    ImGui::Text("lBuffer avg probe: %.2f", resolved == 0 ? 0.0 : (double)data->lBuffer_probes / (double)resolved);
+    ImGui::Text("lBuffer evictions: %u, failures: %u", data->lBuffer_evictions, data->lBuffer_failures);
+
+    if(!data->lBuffer_model_probes.empty()){
+        ImGui::Text("lBuffer model: load %.3f, evictions %.4f, failures %.4f per lookup", data->lBuffer_model_load, data->lBuffer_model_evictions, data->lBuffer_model_failures);
+        ImGui::PlotHistogram("model probe lengths", data->lBuffer_model_probes.data(), (int)data->lBuffer_model_probes.size(), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+    }
+}
+
+void Info::DrawOctree(){
+    if(data->compact_ray_before_ms > 0){
+        if(data->compact_ray_after_ms > 0)
+            ImGui::Text("ray pass around compaction: %f -> %f ms", data->compact_ray_before_ms, data->compact_ray_after_ms);
+        else
+            ImGui::Text("ray pass before compaction: %f ms, settling", data->compact_ray_before_ms);
+    }
+
+    const core::OctreeStats &stats = data->octree_stats;
+    if(stats.nodes.empty()){
+        ImGui::Text("not counted yet, see count octree in the controls");
+        return;
+    }
+
+    ImGui::Text("slots: %u used, %u allocated, %u reachable", stats.slots, stats.capacity, stats.reachable);
+    ImGui::Text("free list: %u blocks, doubling slack: %u slots", stats.freeBlocks, stats.capacity - stats.slots);
+    ImGui::Text("fragmentation: %.1f%%", stats.fragmentation * 100.0f);
+
+    uint32_t coarse = 0;
+    for(size_t i = 0; i + 1 < stats.leaves.size(); i++)
+        coarse += stats.leaves[i];
+    ImGui::Text("leaves: %u, coarse: %u", stats.leaves.back() + coarse, coarse);
+
+    std::vector<float> nodes(stats.nodes.begin(), stats.nodes.end()), leaves(stats.leaves.begin(), stats.leaves.end());
+    ImGui::PlotHistogram("nodes per depth", nodes.data(), nodes.size(), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+    ImGui::PlotHistogram("leaves per depth", leaves.data(), leaves.size(), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+    ImGui::PlotHistogram("fill per depth", stats.fill.data(), stats.fill.size(), 0, nullptr, 0.0f, 1.0f, ImVec2(0, 60));
+    ImGui::Text("counted in %f ms", stats.ms);
+
+    if(ImGui::Button("export json")){
+        std::ofstream file("./octree_stats.json");
+        file << stats.json();
+        AddLog("[%f] %s ./octree_stats.json \n", glfwGetTime(), file ? "wrote" : "could not write");
+    }
+}
+
+void Info::DrawSceneData(){
+    ImGui::Text("num voxels: %u", data->voxels_num);
+    ImGui::Text("occlusion bake: %u leaves in %f ms", data->occlusion_leaves, data->cpu_occlusion_ms);
+    ImGui::Text("normals: %u recomputed, %u tiles pending", data->normal_leaves, data->normal_tiles_pending);
+    ImGui::Text("cam position:  \n     x:%f \n     y:%f \n     z:%f", data->cam_position.x, data->cam_position.y, data->cam_position.z);
+    ImGui::Text("cam direction: \n     x:%f \n     y:%f \n     z:%f", data->cam_direction.x, data->cam_direction.y, data->cam_direction.z);
+}
+
+void Info::DrawJobs(){
+    ImGui::Text("first frame: %f ms", data->startup_ms);
+    ImGui::Text("scene build: %f ms, %.1f%% worker utilization", data->scene_ms, data->scene_utilization * 100.0f);
+    ImGui::Text("jobs: %llu executed, %llu stolen", (unsigned long long)data->jobs_executed, (unsigned long long)data->jobs_stolen);
+    ImGui::PlotHistogram("workers", data->worker_utilization.data(), data->worker_utilization.size(), 0, nullptr, 0.0f, 1.0f, ImVec2(0, 60));
+    ImGui::Text("capture: %llu frames, %llu dropped, %u buffers busy", (unsigned long long)data->capture_frames, (unsigned long long)data->capture_dropped, data->capture_busy);
+}
+
+void Info::Draw()
+{
+    if (!ImGui::Begin(name))
+    {
+        ImGui::End();
+        return;
+    }
+
+    if(data->scene_progress < 1.0f){
+        char overlay[32];
+        snprintf(overlay, sizeof(overlay), "building scene %.0f%%", data->scene_progress * 100.0f);
+        ImGui::ProgressBar(data->scene_progress, ImVec2(-1.0f, 0.0f), overlay);
+    }
+
+    if(ImGui::CollapsingHeader("profiler", ImGuiTreeNodeFlags_DefaultOpen))
+        DrawProfiler();
+    if(ImGui::CollapsingHeader("scene data"))
+        DrawSceneData();
+    if(ImGui::CollapsingHeader("memory usage"))
+        DrawMemUsage();
+    if(ImGui::CollapsingHeader("octree"))
+        DrawOctree();
+    if(ImGui::CollapsingHeader("jobs"))
+        DrawJobs();
+    if(ImGui::CollapsingHeader("logger", ImGuiTreeNodeFlags_DefaultOpen))
+        DrawLog();
+
+    ImGui::End();
 }
\ No newline at end of file
@@ -1,22 +1,22 @@
-#include "widget.hpp"
-
-Widget::Widget(){
-
-}
-
-Widget::Widget(const char* name_) : 
-    name(name_)
-{
-    
-}
-
-void Widget::Render(){
-    Draw();
-}
-
-void Widget::Draw(){
-}
-
-Widget::~Widget(){
-
+#include "widget.hpp"
+
+Widget::Widget(){
+
+}
+
+Widget::Widget(const char* name_) : 
+    name(name_)
+{
+    
+}
+
+void Widget::Render(){
+    Draw();
+}
+
+void Widget::Draw(){
+}
+
+Widget::~Widget(){
+
 }
\ No newline at end of file
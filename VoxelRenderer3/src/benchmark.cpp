@@ -0,0 +1,283 @@
+#include "benchmark.hpp"
+
+#include <cstddef>
+#include <cmath>
+#include <limits>
+
+namespace{
+    struct PresetField{
+        const char *name;
+        char type;  //i int, f float, b bool, r RenderType
+        size_t offset;
+    };
+
+    const PresetField presetFields[] = {
+        {"renderType", 'r', offsetof(core::FrameConfig, renderType)},
+        {"lBufferSwapSeconds", 'f', offsetof(core::FrameConfig, lBufferSwapSeconds)},
+        {"TAA", 'b', offsetof(core::FrameConfig, TAA)},
+        {"beamPrepass", 'b', offsetof(core::FrameConfig, beamPrepass)},
+        {"fuseAverage", 'b', offsetof(core::FrameConfig, fuseAverage)},
+        {"spp", 'i', offsetof(core::FrameConfig, spp)},
+        {"bounces", 'i', offsetof(core::FrameConfig, bounces)},
+        {"controlchecks", 'i', offsetof(core::FrameConfig, controlchecks)},
+        {"lodBias", 'f', offsetof(core::FrameConfig, lodBias)},
+        {"bakeOcclusion", 'b', offsetof(core::FrameConfig, bakeOcclusion)},
+        {"recomputeNormals", 'b', offsetof(core::FrameConfig, recomputeNormals)},
+        {"ropes", 'b', offsetof(core::FrameConfig, ropes)},
+        {"compactOctree", 'b', offsetof(core::FrameConfig, compactOctree)},
+        {"compactDepthFirst", 'b', offsetof(core::FrameConfig, compactDepthFirst)},
+        {"ambient", 'f', offsetof(core::FrameConfig, ambient)},
+        {"injectBudget", 'i', offsetof(core::FrameConfig, injectBudget)},
+        {"coneSteps", 'i', offsetof(core::FrameConfig, coneSteps)},
+        {"progressive", 'b', offsetof(core::FrameConfig, progressive)},
+        {"convergenceThreshold", 'f', offsetof(core::FrameConfig, convergenceThreshold)},
+        {"convergedRatio", 'f', offsetof(core::FrameConfig, convergedRatio)},
+        {"minSamples", 'i', offsetof(core::FrameConfig, minSamples)},
+    };
+
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+
+    //empty cell for a frame without a GPU sample
+    std::string cell(double value){
+        if(std::isnan(value))
+            return "";
+        std::ostringstream out;
+        out << value;
+        return out.str();
+    }
+
+    double percentile(std::vector<double> sorted, double p){
+        if(sorted.empty())
+            return 0.0;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = (size_t)std::ceil(p * (double)sorted.size());
+        return sorted[rank == 0 ? 0 : rank - 1];
+    }
+}
+
+bool CameraPath::load(const char *path, const core::FrameConfig &defaults){
+    std::ifstream file(path);
+    if(!file.is_open())
+        return false;
+
+    preset = defaults;
+    keys.clear();
+
+    std::string line;
+    while(std::getline(file, line)){
+        std::istringstream tokens(line);
+        std::string entry;
+        if(!(tokens >> entry) || entry[0] == '#')
+            continue;
+
+        if(entry == "timestep"){
+            tokens >> timeStep;
+        }else if(entry == "warmup"){
+            tokens >> warmup;
+        }else if(entry == "key"){
+            Key key;
+            tokens >> key.time >> key.position.x >> key.position.y >> key.position.z >> key.direction.x >> key.direction.y >> key.direction.z;
+            if(tokens)
+                keys.push_back(key);
+        }else if(entry == "preset"){
+            std::string name;
+            double value;
+            if(!(tokens >> name >> value))
+                continue;
+            for(const PresetField &field : presetFields){
+                if(name != field.name)
+                    continue;
+                char *target = (char*)&preset + field.offset;
+                switch(field.type){
+                    case 'i': *(int*)target = (int)value; break;
+                    case 'f': *(float*)target = (float)value; break;
+                    case 'b': *(bool*)target = value != 0.0; break;
+                    case 'r': *(core::RenderType*)target = (core::RenderType)(int)value; break;
+                }
+            }
+        }
+    }
+    return !keys.empty() && timeStep > 0.0;
+}
+
+bool CameraPath::save(const char *path) const{
+    std::ofstream file(path);
+    if(!file.is_open())
+        return false;
+
+    file << "# camera path, replay with --benchmark <file>\n";
+    for(const PresetField &field : presetFields){
+        const char *source = (const char*)&preset + field.offset;
+        file << "preset " << field.name << " ";
+        switch(field.type){
+            case 'i': file << *(const int*)source; break;
+            case 'f': file << *(const float*)source; break;
+            case 'b': file << (*(const bool*)source ? 1 : 0); break;
+            case 'r': file << (int)*(const core::RenderType*)source; break;
+        }
+        file << "\n";
+    }
+    file << "timestep " << timeStep << "\n";
+    file << "warmup " << warmup << "\n";
+
+    file.precision(9);
+    for(const Key &key : keys)
+        file << "key " << key.time << " " << key.position.x << " " << key.position.y << " " << key.position.z << " "
+             << key.direction.x << " " << key.direction.y << " " << key.direction.z << "\n";
+    return file.good();
+}
+
+double CameraPath::duration() const{
+    return keys.empty() ? 0.0 : keys.back().time - keys.front().time;
+}
+
+void CameraPath::sample(double time, glm::vec3 &position, glm::vec3 &direction) const{
+    time += keys.front().time;
+    size_t i = 0;
+    while(i + 2 < keys.size() && keys[i + 1].time <= time)
+        i++;
+    if(keys.size() == 1){
+        position = keys[0].position;
+        direction = keys[0].direction;
+        return;
+    }
+
+    const Key &k0 = keys[i == 0 ? 0 : i - 1], &k1 = keys[i], &k2 = keys[i + 1], &k3 = keys[std::min(i + 2, keys.size() - 1)];
+    double span = k2.time - k1.time;
+    float u = span <= 0.0 ? 1.0f : (float)glm::clamp((time - k1.time) / span, 0.0, 1.0);
+    float u2 = u * u, u3 = u2 * u;
+
+    //uniform Catmull-Rom, passes through every key
+    auto spline = [&](glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3){
+        return 0.5f * ((2.0f * p1) + (p2 - p0) * u + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * u2 + (3.0f * p1 - p0 - 3.0f * p2 + p3) * u3);
+    };
+    position = spline(k0.position, k1.position, k2.position, k3.position);
+    direction = spline(k0.direction, k1.direction, k2.direction, k3.direction);
+    if(glm::length(direction) < 0.001f)
+        direction = k1.direction;
+    direction = glm::normalize(direction);
+}
+
+Benchmark::Benchmark(const CameraPath &path_) : path(path_){
+}
+
+bool Benchmark::step(FPCamera *camera){
+    time = frame < path.warmup ? 0.0 : (double)(frame - path.warmup) * path.timeStep;
+    if(time > path.duration())
+        return false;
+
+    glm::vec3 position, direction;
+    path.sample(time, position, direction);
+    camera->setView(position, direction);
+    frame++;
+    return true;
+}
+
+double Benchmark::clock() const{
+    return frame == 0 ? 0.0 : (double)(frame - 1) * path.timeStep;
+}
+
+void Benchmark::record(const core::DebugInfo &debug, double frame_ms, double run_ms){
+    if(frame > path.warmup){
+        frames.push_back({
+            .rendered = debug.frame,
+            .time = time,
+            .frame_ms = frame_ms,
+            .run_ms = run_ms,
+            .ray_ms = missing,
+            .beam_ms = missing,
+            .accum_ms = missing,
+            .avg_ms = missing,
+            .cone_ms = missing,
+            .fetches = debug.traversal_rays == 0 ? 0.0 : (double)debug.traversal_fetches / (double)debug.traversal_rays
+        });
+    }
+
+    //the renderer keeps showing the last result until the next one is read, only a new query frame is a new sample
+    struct Sample{
+        double Frame::*value;
+        double ms;
+        uint64_t frame;
+    };
+    const Sample samples[] = {
+        {&Frame::ray_ms, debug.gpu_ray_query_ms, debug.gpu_ray_query_frame},
+        {&Frame::beam_ms, debug.gpu_beam_query_ms, debug.gpu_beam_query_frame},
+        {&Frame::accum_ms, debug.gpu_accum_query_ms, debug.gpu_accum_query_frame},
+        {&Frame::avg_ms, debug.gpu_avg_query_ms, debug.gpu_avg_query_frame},
+        {&Frame::cone_ms, debug.gpu_cone_query_ms, debug.gpu_cone_query_frame},
+    };
+    for(size_t s = 0; s < 5; s++){
+        if(samples[s].frame <= issued[s])
+            continue;
+        issued[s] = samples[s].frame;
+        //queries issued during the warmup find no row and are dropped
+        for(size_t i = frames.size(); i-- > 0 && frames[i].rendered >= samples[s].frame;){
+            if(frames[i].rendered == samples[s].frame){
+                frames[i].*samples[s].value = samples[s].ms;
+                break;
+            }
+        }
+    }
+}
+
+bool Benchmark::writeCsv(const char *path) const{
+    std::ofstream file(path);
+    if(!file.is_open())
+        return false;
+
+    file << "frame,time,frame_ms,run_ms,gpu_ray_ms,gpu_beam_ms,gpu_accum_ms,gpu_avg_ms,gpu_cone_ms,fetches_per_ray\n";
+    for(size_t i = 0; i < frames.size(); i++){
+        const Frame &f = frames[i];
+        file << i << "," << f.time << "," << f.frame_ms << "," << f.run_ms << "," << cell(f.ray_ms) << "," << cell(f.beam_ms) << "," << cell(f.accum_ms) << ","
+             << cell(f.avg_ms) << "," << cell(f.cone_ms) << "," << f.fetches << "\n";
+    }
+    return file.good();
+}
+
+std::string Benchmark::report() const{
+    struct Column{
+        const char *name;
+        double Frame::*value;
+    };
+    const Column columns[] = {
+        {"frame", &Frame::frame_ms},
+        {"Renderer::run", &Frame::run_ms},
+        {"rayPass (query)", &Frame::ray_ms},
+        {"beamPass (query)", &Frame::beam_ms},
+        {"accumPass (query)", &Frame::accum_ms},
+        {"avgPass (query)", &Frame::avg_ms},
+        {"conePass (query)", &Frame::cone_ms},
+    };
+
+    std::ostringstream out;
+    out << frames.size() << " frames, " << path.duration() << " s of path\n";
+    for(const Column &column : columns){
+        //frames without a sample of this column are left out
+        std::vector<double> values;
+        size_t worst = 0;
+        double worstMs = 0.0;
+        for(size_t i = 0; i < frames.size(); i++){
+            double value = frames[i].*column.value;
+            if(std::isnan(value))
+                continue;
+            if(values.empty() || value > worstMs){
+                worst = i;
+                worstMs = value;
+            }
+            values.push_back(value);
+        }
+        char line[256];
+        snprintf(line, sizeof(line), "%-18s p50 %8.3f  p95 %8.3f  p99 %8.3f  worst %8.3f ms (frame %zu), %zu samples\n", column.name,
+            percentile(values, 0.5), percentile(values, 0.95), percentile(values, 0.99), worstMs, worst, values.size());
+        out << line;
+    }
+
+    std::vector<double> fetches;
+    for(const Frame &f : frames)
+        fetches.push_back(f.fetches);
+    char line[256];
+    snprintf(line, sizeof(line), "%-18s p50 %8.3f  p95 %8.3f  p99 %8.3f  octree texels per ray\n", "fetches",
+        percentile(fetches, 0.5), percentile(fetches, 0.95), percentile(fetches, 0.99));
+    out << line;
+    return out.str();
+}
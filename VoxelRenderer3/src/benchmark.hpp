@@ -0,0 +1,71 @@
+#pragma once
+
+#include "./renderer/core.hpp"
+#include "fpcamera.hpp"
+
+// Camera path files are plain text, one entry per line:
+//   preset <FrameConfig field> <value>
+//   timestep <seconds advanced per frame>
+//   warmup <frames held on the first key before recording>
+//   key <time> <position xyz> <direction xyz>
+// playback flies a Catmull-Rom spline through the keys one time step per frame,
+// however long the frames actually take. The ray seeds and the lighting buffer clock
+// follow the same path time, so every run traces the same samples along the same
+// camera path; only the order GPU atomics land in can still differ.
+class CameraPath{
+    public:
+        struct Key{
+            double time;
+            glm::vec3 position;
+            glm::vec3 direction;
+        };
+
+        core::FrameConfig preset;
+        double timeStep = 1.0 / 60.0;
+        uint32_t warmup = 10;
+        std::vector<Key> keys;
+
+        //fields missing from the file keep their value in defaults
+        bool load(const char *path, const core::FrameConfig &defaults);
+        bool save(const char *path) const;
+
+        double duration() const;
+        void sample(double time, glm::vec3 &position, glm::vec3 &direction) const;
+};
+
+class Benchmark{
+    public:
+        struct Frame{
+            uint64_t rendered;  //DebugInfo::frame it was rendered as
+            double time;        //path time
+            double frame_ms;    //whole main loop iteration
+            double run_ms;      //Renderer::run on the CPU
+            double ray_ms;      //GPU timer queries of this frame, NaN when none was issued or read back
+            double beam_ms;
+            double accum_ms;
+            double avg_ms;
+            double cone_ms;
+            double fetches;     //octree texels per ray of the last counted rayPass
+        };
+
+        explicit Benchmark(const CameraPath &path_);
+
+        //places the camera for the next frame, false once the path is done
+        bool step(FPCamera *camera);
+        //path seconds of the frame placed last, warmup included, the renderer runs on it instead of wall time
+        double clock() const;
+        //GPU times are filed under the frame that issued their query once they come back
+        void record(const core::DebugInfo &debug, double frame_ms, double run_ms);
+
+        bool writeCsv(const char *path) const;
+        //p50, p95, p99 and worst frame of every column
+        std::string report() const;
+
+        CameraPath path;
+        std::vector<Frame> frames;
+
+    private:
+        uint32_t frame = 0;
+        double time = 0.0;
+        uint64_t issued[5] = {};    //newest query frame seen per GPU column
+};
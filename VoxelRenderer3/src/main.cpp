@@ -1,11 +1,21 @@
-#include "voxelengine.hpp"
-
-int main()
-{
-    const VoxelEngine::Config config = { 
-        .windowSize=glm::ivec2(1200, 900),
-        .viewportAspectRatio=4.0f/3.0f,
-        .windowName="VoxelEngine"
-    };
-    VoxelEngine engine(&config);
-} 
\ No newline at end of file
+#include "voxelengine.hpp"
+#include <cstring>
+
+int main(int argc, char **argv)
+{
+    VoxelEngine::Config config = { 
+        .windowSize=glm::ivec2(1200, 900),
+        .viewportAspectRatio=4.0f/3.0f,
+        .windowName="VoxelEngine"
+    };
+
+    //--benchmark <path file> [--csv <output>]
+    for(int i = 1; i + 1 < argc; i++){
+        if(strcmp(argv[i], "--benchmark") == 0)
+            config.benchmarkPath = argv[++i];
+        else if(strcmp(argv[i], "--csv") == 0)
+            config.benchmarkCsv = argv[++i];
+    }
+
+    VoxelEngine engine(&config);
+}
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include "capture.hpp"
+
+Capture::Capture(Config config_, core::RendererConfig *rendererConfig_, JobSystem *jobs_) : config(config_), rendererConfig(rendererConfig_), jobs(jobs_){
+    slots.resize(std::max(config.ring, 2u));
+    for(Slot &slot : slots)
+        glGenBuffers(1, &slot.buffer);
+}
+
+Capture::~Capture(){
+    for(Slot &slot : slots){
+        if(slot.job)
+            jobs->wait(slot.job);
+        release(slot);
+        if(slot.fence)
+            glDeleteSync(slot.fence);
+        glDeleteBuffers(1, &slot.buffer);
+    }
+}
+
+Capture::Video::~Video(){
+    fclose(file);
+}
+
+void Capture::screenshot(const char *path){
+    pendingScreenshot = path;
+}
+
+bool Capture::startVideo(const char *path, uint32_t fps){
+    stopVideo();
+    FILE *file = fopen(path, "wb");
+    if(!file)
+        return false;
+    video = std::make_shared<Video>();
+    video->file = file;
+    video->size = glm::ivec2(0);
+    video->fps = std::max(fps, 1u);
+    video->header = false;
+    return true;
+}
+
+//frames still in flight keep the file open until they are written
+void Capture::stopVideo(){
+    video.reset();
+}
+
+bool Capture::recording() const{
+    return video != nullptr;
+}
+
+bool Capture::wanted() const{
+    return video || !pendingScreenshot.empty();
+}
+
+void Capture::read(GLuint texture, glm::ivec2 origin, glm::ivec2 size){
+    PROFILE_ZONE("capture read");
+    Slot &slot = slots[next];
+    if(slot.fence || slot.job){
+        if(video)
+            stats.dropped++;
+        return;
+    }
+
+    //y4m has no way to change the frame size mid stream
+    if(video && video->size != glm::ivec2(0) && video->size != size){
+        rendererConfig->logMessage("[%f] framebuffer resized, video capture stopped \n", glfwGetTime());
+        stopVideo();
+        if(pendingScreenshot.empty())
+            return;
+    }
+    if(video && video->size == glm::ivec2(0))
+        video->size = size;
+
+    size_t bytes = (size_t)size.x * size.y * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    if(bytes > slot.capacity){
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, NULL, GL_STREAM_READ);
+        slot.capacity = bytes;
+    }
+    //with a pack buffer bound the pointer is an offset into it, the copy is queued instead of waited for
+    if(texture){
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }else{
+        glReadPixels(origin.x, origin.y, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.size = size;
+    slot.path = pendingScreenshot;
+    slot.video = video;
+    pendingScreenshot.clear();
+    next = (next + 1) % slots.size();
+}
+
+void Capture::poll(){
+    PROFILE_ZONE("capture poll");
+    for(Slot &slot : slots){
+        if(slot.job && jobs->finished(slot.job)){
+            stats.frames++;
+            release(slot);
+        }
+    }
+
+    while(slots[head].fence){
+        Slot &slot = slots[head];
+        GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            break;
+        glDeleteSync(slot.fence);
+        slot.fence = 0;
+        head = (head + 1) % slots.size();
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        slot.pixels = (uint8_t*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (size_t)slot.size.x * slot.size.y * 4, GL_MAP_READ_BIT);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if(!slot.pixels){
+            rendererConfig->logMessage("[%f] could not map a capture buffer \n", glfwGetTime());
+            release(slot);
+            continue;
+        }
+
+        //the job owns its video reference so the file closes as soon as the last frame is written
+        const uint8_t *pixels = slot.pixels;
+        glm::ivec2 size = slot.size;
+        std::string path = slot.path;
+        std::shared_ptr<Video> frameVideo = std::move(slot.video);
+        bool videoFrame = frameVideo != nullptr;
+        core::RendererConfig *log = rendererConfig;
+        JobSystem *pool = jobs;
+        slot.job = jobs->create([pixels, size, path, frameVideo = std::move(frameVideo), log, pool]() mutable {
+            PROFILE_ZONE("capture encode");
+            if(!path.empty()){
+                bool written = writePng(path.c_str(), pixels, size);
+                pool->runOnMain([log, path, written](){
+                    if(written)
+                        log->logMessage("[%f] saved screenshot %s \n", glfwGetTime(), path.c_str());
+                    else
+                        log->logMessage("[%f] could not write %s \n", glfwGetTime(), path.c_str());
+                });
+            }
+            if(frameVideo){
+                if(!frameVideo->header){
+                    fprintf(frameVideo->file, "YUV4MPEG2 W%d H%d F%u:1 Ip A1:1 C420jpeg\n", size.x, size.y, frameVideo->fps);
+                    frameVideo->header = true;
+                }
+                writeY4mFrame(frameVideo->file, pixels, size);
+                frameVideo.reset();
+            }
+        });
+        //workers would otherwise append the frames of a video in whatever order they finish
+        if(videoFrame){
+            if(lastFrame)
+                jobs->depend(slot.job, lastFrame);
+            lastFrame = slot.job;
+        }
+        jobs->submit(slot.job);
+    }
+
+    stats.busy = 0;
+    for(const Slot &slot : slots)
+        stats.busy += (slot.fence || slot.job) ? 1 : 0;
+}
+
+void Capture::release(Slot &slot){
+    if(slot.pixels){
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.pixels = nullptr;
+    }
+    slot.job.reset();
+    slot.path.clear();
+    slot.video.reset();
+}
+
+static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t length){
+    static const std::vector<uint32_t> table = [](){
+        std::vector<uint32_t> t(256);
+        for(uint32_t n = 0; n < 256; n++){
+            uint32_t c = n;
+            for(int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for(size_t i = 0; i < length; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void putBigEndian(std::vector<uint8_t> &out, uint32_t value){
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+static void putChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data){
+    putBigEndian(out, data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    putBigEndian(out, crc32(0, out.data() + start, out.size() - start));
+}
+
+//RGB without filtering in stored deflate blocks, encoding has to keep up with the frame rate rather than be small
+bool Capture::writePng(const char *path, const uint8_t *rgba, glm::ivec2 size){
+    size_t rowBytes = 1 + (size_t)size.x * 3;
+    std::vector<uint8_t> raw(rowBytes * size.y);
+    for(int y = 0; y < size.y; y++){
+        const uint8_t *src = rgba + (size_t)(size.y - 1 - y) * size.x * 4;
+        uint8_t *dst = raw.data() + (size_t)y * rowBytes;
+        *dst++ = 0;
+        for(int x = 0; x < size.x; x++, src += 4){
+            *dst++ = src[0];
+            *dst++ = src[1];
+            *dst++ = src[2];
+        }
+    }
+
+    std::vector<uint8_t> header;
+    putBigEndian(header, size.x);
+    putBigEndian(header, size.y);
+    header.insert(header.end(), {8, 2, 0, 0, 0});   //8 bit RGB, deflate, no filter, no interlace
+
+    const size_t block = 65535;
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    zlib.reserve(raw.size() + raw.size() / block * 5 + 16);
+    uint32_t a = 1, b = 0;
+    for(size_t offset = 0; offset < raw.size(); offset += block){
+        uint16_t length = (uint16_t)std::min(block, raw.size() - offset);
+        zlib.push_back(offset + length >= raw.size() ? 1 : 0);
+        zlib.push_back(length & 0xFF);
+        zlib.push_back(length >> 8);
+        zlib.push_back(~length & 0xFF);
+        zlib.push_back((uint16_t)~length >> 8);
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+        for(size_t i = offset; i < offset + length; i++){
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+    }
+    putBigEndian(zlib, (b << 16) | a);
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<uint8_t> png(signature, signature + 8);
+    putChunk(png, "IHDR", header);
+    putChunk(png, "IDAT", zlib);
+    putChunk(png, "IEND", {});
+
+    FILE *file = fopen(path, "wb");
+    if(!file)
+        return false;
+    bool written = fwrite(png.data(), 1, png.size(), file) == png.size();
+    return fclose(file) == 0 && written;
+}
+
+//full range BT.601, chroma averaged over 2x2 pixels
+void Capture::writeY4mFrame(FILE *file, const uint8_t *rgba, glm::ivec2 size){
+    glm::ivec2 half = (size + glm::ivec2(1)) / 2;
+    std::vector<uint8_t> planes((size_t)size.x * size.y + 2 * (size_t)half.x * half.y);
+    uint8_t *luma = planes.data();
+    uint8_t *cb = luma + (size_t)size.x * size.y;
+    uint8_t *cr = cb + (size_t)half.x * half.y;
+
+    auto pixel = [&](int x, int y){
+        const uint8_t *p = rgba + ((size_t)(size.y - 1 - std::min(y, size.y - 1)) * size.x + std::min(x, size.x - 1)) * 4;
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+    for(int y = 0; y < size.y; y++){
+        for(int x = 0; x < size.x; x++){
+            glm::vec3 c = pixel(x, y);
+            luma[(size_t)y * size.x + x] = (uint8_t)glm::clamp(glm::dot(c, glm::vec3(0.299f, 0.587f, 0.114f)) + 0.5f, 0.0f, 255.0f);
+        }
+    }
+    for(int y = 0; y < half.y; y++){
+        for(int x = 0; x < half.x; x++){
+            glm::vec3 c = (pixel(2 * x, 2 * y) + pixel(2 * x + 1, 2 * y) + pixel(2 * x, 2 * y + 1) + pixel(2 * x + 1, 2 * y + 1)) * 0.25f;
+            cb[(size_t)y * half.x + x] = (uint8_t)glm::clamp(glm::dot(c, glm::vec3(-0.168736f, -0.331264f, 0.5f)) + 128.5f, 0.0f, 255.0f);
+            cr[(size_t)y * half.x + x] = (uint8_t)glm::clamp(glm::dot(c, glm::vec3(0.5f, -0.418688f, -0.081312f)) + 128.5f, 0.0f, 255.0f);
+        }
+    }
+
+    fputs("FRAME\n", file);
+    fwrite(planes.data(), 1, planes.size(), file);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "core.hpp"
+#include "jobs.hpp"
+
+// Screenshots and video of the final image without stalling the pipeline. Frames are read into
+// a ring of pixel pack buffers, a fence marks when each copy is done and the buffer is only mapped
+// by a later frame once it has signaled. Encoding runs as a job on the mapped memory, the buffer
+// goes back to the ring when the job has finished. Frames arriving while every buffer is busy are
+// dropped rather than waited for. Screenshots are PNG, video is a raw YUV4MPEG2 (.y4m) stream.
+class Capture{
+    public:
+        struct Config{
+            uint32_t ring;      //pixel pack buffers, copies in flight plus frames being encoded
+        };
+
+        struct Stats{
+            uint64_t frames = 0;    //encoded, screenshots included
+            uint64_t dropped = 0;   //video frames lost to a full ring
+            uint32_t busy = 0;      //buffers in flight or being encoded
+        };
+
+        Capture(Config config_, core::RendererConfig *rendererConfig_, JobSystem *jobs_);
+        ~Capture();
+
+        //the next captured frame is written to path
+        void screenshot(const char *path);
+        //every frame from now on is appended to path, played back at fps
+        bool startVideo(const char *path, uint32_t fps);
+        void stopVideo();
+        bool recording() const;
+
+        //whether the current frame has to be read
+        bool wanted() const;
+        //queues the copy of size pixels at origin, from texture or from the bound read framebuffer when 0
+        void read(GLuint texture, glm::ivec2 origin, glm::ivec2 size);
+        //maps finished copies and recycles encoded buffers, never blocks
+        void poll();
+
+        Stats stats;
+        Config config;
+
+    private:
+        //a y4m file, closed once the last frame referencing it is written
+        struct Video{
+            FILE *file;
+            glm::ivec2 size;    //taken from the first frame
+            uint32_t fps;
+            bool header;        //only touched by the chained frame jobs
+            ~Video();
+        };
+
+        struct Slot{
+            GLuint buffer = 0;
+            size_t capacity = 0;
+            glm::ivec2 size;
+            GLsync fence = 0;           //copy in flight
+            uint8_t *pixels = nullptr;  //mapped while encoding
+            JobSystem::Handle job;
+            std::string path;           //screenshot, empty for video frames
+            std::shared_ptr<Video> video;
+        };
+
+        core::RendererConfig *rendererConfig;
+        JobSystem *jobs;
+
+        std::vector<Slot> slots;
+        uint32_t head = 0;      //oldest slot in flight, copies complete in ring order
+        uint32_t next = 0;      //slot the next copy goes into
+
+        std::string pendingScreenshot;
+        std::shared_ptr<Video> video;
+        JobSystem::Handle lastFrame;    //video frames are chained so they are written in order
+
+        void release(Slot &slot);
+
+        //rows come bottom up like GL returns them
+        static bool writePng(const char *path, const uint8_t *rgba, glm::ivec2 size);
+        static void writeY4mFrame(FILE *file, const uint8_t *rgba, glm::ivec2 size);
+};
@@ -1,127 +1,359 @@
-#pragma once
-#include <iostream>
-#include <fstream>
-#include <sstream>
-#include <vector>
-#include <cstdint>
-#include <string>
-#include <stdio.h>
-#include <functional>
-#include <cstdarg>
-
-#include <glad/glad.h>
-#include <GLFW/glfw3.h> // Will drag system OpenGL headers
-
-#include <glm/vec4.hpp>
-#include <glm/vec3.hpp>
-#include <glm/vec2.hpp>
-#include <glm/geometric.hpp>
-#include <glm/gtx/euler_angles.hpp>
-#include <glm/gtx/rotate_vector.hpp>
-
-namespace core{
-    typedef std::function<void(const char*, va_list args)> logFunc;
-    typedef std::function<glm::ivec2()> framebufferSizeFunc;
-
-    struct RendererConfig {
-        logFunc log;
-        framebufferSizeFunc framebufferSize;
-        float aspectRatio; 
-        bool debuggingEnabled;
-
-        glm::ivec2 lBufferSize = glm::ivec2(-1, -1);
-
-        void logMessage(const char* format, ...) const {
-            va_list args;
-            va_start(args, format);
-            log(format, args);
-            va_end(args);
-        }
-    };
-
-    struct ComputePass{
-        GLuint shader, program;
-        glm::ivec2 groupSize;
-        glm::ivec2 globalSize;
-        GLuint texture;
-    };
-
-    struct RasterPass{
-        GLuint vertexShader, fragmentShader, program;
-        GLuint VBO, VAO;
-        GLuint framebuffer, rbo;
-        GLuint texture;
-    };
-
-    struct lightingBuffer{
-        GLuint texture;
-        glm::ivec2 size;
-        uint8_t stride;
-        uint8_t slots;
-        GLuint instruction;
-        double accumulationTime;
-    };
-
-    enum RenderType{
-        DEFAULT,
-        STRUCTURE,
-        ALBEDO,
-        NORMAL,
-        VOXELID,
-        BUFFERSLOTS
-    };
-
-    struct FrameConfig{
-        RenderType renderType = DEFAULT;
-
-        //lighting buffer updates
-        float lBufferSwapSeconds = 0.08;
-        bool TAA = false;
-
-        //raytracing
-        int spp = 1;
-        int bounces = 2;
-        int controlchecks = 160;
-
-        bool shaderRecompilation = false;
-        bool renderToTexture = false;
-        GLuint texture;
-    };
-
-    struct DebugInfo{
-        //profiling
-        double start_ms = 0;
-        double end_ms = 0;
-
-        //gpu
-        double gpu_start_ms;
-        double gpu_shaderCompilation_ms;
-        double gpu_framebufferResize_ms;
-        double gpu_pass1_ms;
-        double gpu_pass2_ms;
-        double gpu_pass3_ms;
-        double gpu_end_ms;
-
-        //cpu
-        double cpu_start_ms = 0;
-        double cpu_end_ms = 0;
-
-        //mem
-        uint32_t scene_capacity = 0;
-        uint32_t scene_mem = 0;
-        uint32_t lBuffer_mem = 0;
-
-        //scene
-        uint32_t voxels_num = 0;
-        glm::vec3 cam_position;
-        glm::vec3 cam_direction;
-    };
-
-    struct runtimeRendererMem{
-        glm::ivec2 displaySize;
-        glm::ivec2 framebufferSize;
-        glm::ivec2 framebufferPos;
-        float aspectRatio;
-        uint8_t texturesBound;
-    };
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <stdio.h>
+#include <functional>
+#include <algorithm>
+#include <cstdarg>
+
+#include "profiler.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h> // Will drag system OpenGL headers
+
+#include <glm/vec4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec2.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtx/euler_angles.hpp>
+#include <glm/gtx/rotate_vector.hpp>
+
+namespace core{
+    typedef std::function<void(const char*, va_list args)> logFunc;
+    typedef std::function<glm::ivec2()> framebufferSizeFunc;
+
+    struct RendererConfig {
+        logFunc log;
+        framebufferSizeFunc framebufferSize;
+        float aspectRatio; 
+        bool debuggingEnabled;
+
+        glm::ivec2 lBufferSize = glm::ivec2(-1, -1); //entries per row, rows of entries (both rounded down to powers of two)
+        uint32_t lBufferMaxProbe = 16;
+        uint32_t lBufferEvictAge = 50;
+
+        uint32_t occlusionRays = 16;    //hemisphere rays per baked leaf
+        float occlusionRadius = 8.0;    //in leaves
+        uint32_t normalRadius = 2;      //smoothing half width of recomputed normals, in leaves
+
+        void logMessage(const char* format, ...) const {
+            va_list args;
+            va_start(args, format);
+            log(format, args);
+            va_end(args);
+        }
+    };
+
+    //loose uniforms of the passes, their locations are reflected once whenever a program is (re)linked
+    enum Uniform{
+        OCTREE_TEXTURE,
+        OCTREE_DEPTH,
+        ATTRIBUTE_TEXTURE,
+        OCCLUSION_TEXTURE,
+        MODEL_TEXTURE,
+        INSTANCE_COUNT,
+        BEAM_TEXTURE,
+        SCREEN_TEXTURE,
+        LEAF_COUNT,
+        LEAF_OFFSET,
+        BUDGET,
+        LEVEL_OFFSET,
+        LEVEL_SIZE,
+        ROPE_TEXTURE,
+        USE_ROPES,
+        UNIFORM_COUNT
+    };
+
+    struct PassUniforms{
+        GLint location[UNIFORM_COUNT];  //-1 when the program has no such uniform
+    };
+
+    //mirrors the std140 FrameUniform block of the shaders, written once per frame
+    struct FrameUniforms{
+        glm::ivec2 screenResolution;
+        GLint time;             //ray seed
+        GLuint lightingTime;    //lighting buffer clock, 10ms ticks
+        GLint spp;
+        GLint lightBounces;
+        GLuint controlchecks;
+        GLfloat lodBias;
+        GLfloat ambient;
+        GLuint coneSteps;
+        GLint beamTileSize;
+        GLint instruction;
+        GLuint updateTime;
+        GLuint evictAge;
+        GLint countStats;
+        GLint fuseAverage;
+        GLint stride;
+        GLuint widthShift;
+        GLuint capacityMask;
+        GLuint maxProbe;
+        GLint reset;
+        GLint countConvergence;
+        GLint minSamples;
+        GLfloat threshold;
+    };
+    static_assert(sizeof(FrameUniforms) == 96, "FrameUniforms has to match the std140 layout of FrameUniform");
+
+    struct ComputePass{
+        GLuint shader, program;
+        glm::ivec2 groupSize;
+        glm::ivec2 globalSize;
+        PassUniforms uniforms;
+    };
+
+    struct RasterPass{
+        GLuint vertexShader, fragmentShader, program;
+        GLuint VBO, VAO;
+        PassUniforms uniforms;
+    };
+
+    //small counter buffer read back without stalling, a frame only counts while no readback is in flight
+    struct gpuCounters{
+        GLuint buffer;
+        GLsync fence = 0;
+        uint32_t count;
+    };
+
+    //GL_TIME_ELAPSED query read back without stalling, a frame is only timed while no result is in flight
+    struct gpuTimer{
+        GLuint query;
+        bool pending = false;
+        uint64_t frame = 0;     //run() the pending query was issued in
+    };
+
+    struct lightingBuffer{
+        GLuint texture;
+        glm::ivec2 size;
+        uint8_t stride;
+        uint32_t width;     //entries per row
+        uint32_t rows;      //rows of entries
+        uint32_t capacity;
+        uint32_t maxProbe;
+        uint32_t evictAge;
+        GLuint instruction;
+        double accumulationTime;
+
+        gpuCounters stats;  //lookups, claims, probes, evictions, failures (one lookup per voxel and workgroup)
+        gpuCounters occupancy;  //entries holding a key, kept by accum.comp over every frame and only zeroed with the table
+        uint32_t occupied = 0;
+    };
+
+    //mean (rgb: running mean, a: sample count) and variance (rgb: running M2 per channel, a: running M2 of luminance) textures belong to the render graph
+    struct progressiveBuffer{
+        gpuCounters counters;   //converged pixels
+        uint32_t generation = 0;
+        uint32_t countedGeneration = 0;
+        uint32_t countedSamples = 0;
+        uint32_t samples = 0;
+        float convergence = 0;
+        bool converged = false;
+    };
+
+    //per node radiance of the octree, refreshed a budget of leaves per frame and filtered up level by level
+    struct coneTracingBuffer{
+        GLuint radianceBuffer;  //vec4 per node: premultiplied radiance, opacity
+        GLuint leafBuffer;      //uvec4 per solid leaf: node index, position
+        GLuint nodeBuffer;      //internal node indices, one segment with some slack per level
+        std::vector<uint32_t> levelOffsets;
+        std::vector<uint32_t> levelSizes;
+        uint32_t leaves = 0;
+        uint32_t capacity = 0;
+        uint32_t revision = UINT32_MAX;     //octree layout revision the lists belong to, UINT32_MAX while stale
+        uint32_t injectOffset = 0;
+
+        //CPU copies of the lists, patched in place from the octree's slot edits
+        std::vector<glm::uvec4> leafList;
+        std::vector<std::vector<uint32_t>> levelLists;
+        std::vector<uint32_t> levelCapacities;
+        uint32_t leafCapacity = 0;
+        std::vector<uint8_t> listedIn;      //per slot: 0 unlisted, 1 leaf list, 2 + level
+        std::vector<uint32_t> listedAt;     //per slot: its entry in that list
+        glm::uvec2 leafDirty = glm::uvec2(UINT32_MAX, 0);
+        std::vector<glm::uvec2> levelDirty;
+    };
+
+    enum RenderType{
+        DEFAULT,
+        STRUCTURE,
+        ALBEDO,
+        NORMAL,
+        VOXELID,
+        CONETRACING,
+        BUFFERSLOTS
+    };
+
+    struct FrameConfig{
+        RenderType renderType = DEFAULT;
+
+        //lighting buffer updates
+        float lBufferSwapSeconds = 0.08;
+        double clock = -1.0;    //seconds the ray seed and lighting buffer run on, wall time while negative, set by benchmarks
+        bool TAA = false;
+        bool beamPrepass = true;    //per tile start distance for the primary rays
+        bool fuseAverage = false;   //accumPass writes the averages itself, missing contributions of workgroups that run after it
+
+        //raytracing
+        int spp = 1;
+        int bounces = 2;
+        int controlchecks = 160;
+        float lodBias = 1.0;    //pixels a node may cover before rays descend into it, 0 disables LOD
+        bool bakeOcclusion = true;  //rebake ambient occlusion near edits
+        bool recomputeNormals = true;   //re-estimate normals near edits in the background
+        bool ropes = false;         //step into the neighbouring node through its link instead of descending from the root
+        float ambient = 0.5;        //baked occlusion scaled sky light where paths end, 0 disables it
+
+        //cone tracing
+        int injectBudget = 65536;   //leaves relit per frame
+        int coneSteps = 32;
+
+        bool shaderRecompilation = false;
+        bool recordVoxelStream = false;
+        bool replayVoxelStream = false; //run the recorded voxel id frames through the lighting buffer model once
+        bool countOctree = false;   //recount the octree statistics once
+        bool octreeStats = false;   //recount them after edits, at most once a second
+        bool compactOctree = false; //rewrite the node array once in traversal order, on a worker
+        bool compactDepthFirst = true;  //subtrees clustered, breadth first otherwise
+        bool renderToTexture = false;
+        GLuint texture;
+
+        //progressive refinement
+        bool progressive = true;
+        float convergenceThreshold = 0.01;  //max relative standard error of a converged pixel
+        float convergedRatio = 0.995;       //fraction of converged pixels needed to stop tracing
+        int minSamples = 16;
+        float idleWaitSeconds = 0.1;
+    };
+
+    //layout of the volume octree, counted by Octree::computeStats
+    struct OctreeStats{
+        std::vector<uint32_t> nodes;    //internal nodes per depth, index 0 is the top level
+        std::vector<uint32_t> leaves;   //solid leaves per depth, all but the last depth are coarse
+        std::vector<float> fill;        //occupied fraction of the 8 slot blocks of each depth
+        uint32_t slots = 0;             //node slots handed out
+        uint32_t capacity = 0;          //slots allocated, grown by doubling
+        uint32_t reachable = 0;         //slots in blocks reachable from the root
+        uint32_t freeBlocks = 0;        //blocks waiting on the free list
+        float fragmentation = 0;        //share of handed out slots not reachable from the root
+        uint32_t revision = 0;          //octree revision counted
+        double ms = 0;
+
+        std::string json() const;
+    };
+
+    struct DebugInfo{
+        //profiling
+        double start_ms = 0;
+        double end_ms = 0;
+
+        //gpu
+        double gpu_start_ms;
+        double gpu_shaderCompilation_ms;
+        double gpu_framebufferResize_ms;
+        double gpu_pass1_ms;
+        double gpu_pass2_ms;
+        double gpu_pass3_ms;
+        double gpu_progressive_ms;
+        double gpu_end_ms;
+        double gpu_accum_query_ms = 0;  //timer queries, actual GPU time
+        double gpu_avg_query_ms = 0;
+        double gpu_beam_query_ms = 0;
+        double gpu_cone_query_ms = 0;
+        double gpu_ray_query_ms = 0;
+        uint64_t frame = 0;                 //run() calls so far
+        uint64_t gpu_accum_query_frame = 0; //frame each query value above was issued in, 0 before the first one
+        uint64_t gpu_avg_query_frame = 0;
+        uint64_t gpu_beam_query_frame = 0;
+        uint64_t gpu_cone_query_frame = 0;
+        uint64_t gpu_ray_query_frame = 0;
+        uint32_t traversal_rays = 0;        //octree raycasts of a counted rayPass
+        uint32_t traversal_fetches = 0;     //octree texels they read
+        bool traversal_ropes = false;       //counted with ropes
+
+        //cpu
+        double cpu_start_ms = 0;
+        double cpu_end_ms = 0;
+        std::vector<std::pair<const char*, float>> zone_ms;    //profiler zones ended during the last frame, all threads
+        double cpu_occlusion_ms = 0;    //last ambient occlusion bake
+        uint32_t occlusion_leaves = 0;
+        uint32_t normal_leaves = 0;         //normals changed by the last patched tiles
+        uint32_t normal_tiles_pending = 0;
+
+        //job system
+        std::vector<float> worker_utilization;  //busy fraction of every worker over the last frame
+        uint64_t jobs_executed = 0;
+        uint64_t jobs_stolen = 0;
+        double startup_ms = 0;                  //engine start to the first frame
+        double scene_ms = 0;                    //engine start to the last scene chunk committed
+        float scene_utilization = 0;            //average worker utilization while building
+        float scene_progress = 0;               //committed fraction of the scene chunks
+
+        //capture
+        uint64_t capture_frames = 0;
+        uint64_t capture_dropped = 0;
+        uint32_t capture_busy = 0;              //pixel pack buffers in flight or being encoded
+
+        //mem
+        uint32_t scene_capacity = 0;
+        uint32_t scene_mem = 0;
+        OctreeStats octree_stats;
+        double compact_ray_before_ms = 0;   //averaged ray pass around the last compaction
+        double compact_ray_after_ms = 0;    //0 until it settled
+        uint32_t lBuffer_mem = 0;
+        uint32_t gBuffer_mem = 0;
+        uint32_t gBuffer_mem_unaliased = 0;     //one texture per transient
+        uint32_t gBuffer_mem_rgba32f = 0; //same framebuffer size with the previous all RGBA32F + depth layout
+
+        //render graph
+        uint32_t graph_passes = 0;
+        uint32_t graph_culled = 0;
+        uint32_t graph_barriers = 0;
+        uint32_t graph_barriers_blanket = 0;    //one blanket barrier after every writing pass
+
+        //lighting buffer hash table
+        uint32_t lBuffer_capacity = 0;
+        uint32_t lBuffer_occupied = 0;
+        uint32_t lBuffer_lookups = 0;
+        uint32_t lBuffer_claims = 0;
+        uint32_t lBuffer_probes = 0;
+        uint32_t lBuffer_evictions = 0;
+        uint32_t lBuffer_failures = 0;
+        std::vector<float> lBuffer_model_probes;    //CPU model lookups by probe length, last recorded or replayed stream
+        float lBuffer_model_load = 0;
+        float lBuffer_model_evictions = 0;          //per lookup
+        float lBuffer_model_failures = 0;
+
+        //progressive
+        uint32_t progressive_samples = 0;
+        float progressive_convergence = 0;
+        bool converged = false;
+
+        //scene
+        uint32_t voxels_num = 0;
+        glm::vec3 cam_position;
+        glm::vec3 cam_direction;
+    };
+
+    struct runtimeRendererMem{
+        glm::ivec2 displaySize;
+        glm::ivec2 framebufferSize;
+        glm::ivec2 framebufferPos;
+        float aspectRatio;
+        uint8_t texturesBound;
+
+        //last traced state, used to restart progressive accumulation
+        glm::vec3 cameraPosition;
+        glm::vec3 cameraDirection;
+        float cameraFOV;
+        RenderType renderType;
+        int spp, bounces, controlchecks;
+        bool progressive;
+        float lodBias;
+        float ambient;
+    };
 };
\ No newline at end of file
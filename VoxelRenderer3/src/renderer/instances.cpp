@@ -0,0 +1,180 @@
+#include "instances.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/matrix.hpp>
+#include <cfloat>
+
+#define BVH_LEAF_SIZE 2
+
+InstanceScene::InstanceScene(){}
+
+InstanceScene::~InstanceScene(){
+    freeVRAM();
+}
+
+uint32_t InstanceScene::addModel(Octree *model){
+    models.push_back({model, 0, model->revision - 1});
+    modelsDirty = true;
+    return models.size() - 1;
+}
+
+uint32_t InstanceScene::addInstance(uint32_t model, glm::mat4 transform){
+    instances.push_back({model, transform});
+    instancesDirty = true;
+    return instances.size() - 1;
+}
+
+void InstanceScene::setTransform(uint32_t instance, glm::mat4 transform){
+    instances[instance].transform = transform;
+    instancesDirty = true;
+}
+
+//shader positions are twice the leaf units the octrees are edited in
+glm::mat4 InstanceScene::shaderSpace(const glm::mat4 &transform){
+    return glm::scale(glm::mat4(1.0f), glm::vec3(2.0f)) * transform * glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
+}
+
+void InstanceScene::GenBuffers(){
+    glGenBuffers(1, &modelBufferID);
+    glBindBuffer(GL_TEXTURE_BUFFER, modelBufferID);
+    glBufferData(GL_TEXTURE_BUFFER, 4, NULL, GL_DYNAMIC_DRAW);
+
+    glGenTextures(1, &modelTexBufferID);
+    glBindTexture(GL_TEXTURE_BUFFER, modelTexBufferID);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, modelBufferID);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    glGenBuffers(1, &instanceBufferID);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceBufferID);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GPUInstance), NULL, GL_DYNAMIC_DRAW);
+
+    glGenBuffers(1, &bvhBufferID);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bvhBufferID);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GPUNode), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    resident = true;
+    modelsDirty = instancesDirty = true;
+}
+
+void InstanceScene::freeVRAM(){
+    if(!resident)
+        return;
+    resident = false;
+    glDeleteBuffers(1, &modelBufferID);
+    glDeleteTextures(1, &modelTexBufferID);
+    glDeleteBuffers(1, &instanceBufferID);
+    glDeleteBuffers(1, &bvhBufferID);
+}
+
+void InstanceScene::Upload(){
+    PROFILE_ZONE("InstanceScene::Upload");
+    for(Model &model : models)
+        if(model.revision != model.octree->revision)
+            modelsDirty = true;
+
+    if(modelsDirty || instancesDirty)
+        modified = true;
+
+    if(modelsDirty){
+        //every model keeps its relative child offsets, the shader adds the model base
+        std::vector<uint32_t> nodes;
+        for(Model &model : models){
+            model.base = nodes.size();
+            model.revision = model.octree->revision;
+            for(uint32_t i = 0; i < model.octree->size; i++)
+                nodes.push_back(model.octree->data[i].raw);
+        }
+        glBindBuffer(GL_TEXTURE_BUFFER, modelBufferID);
+        glBufferData(GL_TEXTURE_BUFFER, std::max<size_t>(nodes.size(), 1) * sizeof(uint32_t), nodes.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        modelsDirty = false;
+        instancesDirty = true;
+    }
+
+    if(instancesDirty){
+        std::vector<glm::vec3> boundsMin(instances.size()), boundsMax(instances.size());
+        std::vector<glm::mat4> localToWorld(instances.size());
+        for(size_t i = 0; i < instances.size(); i++){
+            localToWorld[i] = shaderSpace(instances[i].transform);
+            float length = (float)(1u << models[instances[i].model].octree->depth);
+            boundsMin[i] = glm::vec3(FLT_MAX);
+            boundsMax[i] = glm::vec3(-FLT_MAX);
+            for(int c = 0; c < 8; c++){
+                glm::vec4 corner = localToWorld[i] * glm::vec4((float)((c >> 2) & 1) * length, (float)((c >> 1) & 1) * length, (float)(c & 1) * length, 1.0f);
+                boundsMin[i] = glm::min(boundsMin[i], glm::vec3(corner));
+                boundsMax[i] = glm::max(boundsMax[i], glm::vec3(corner));
+            }
+        }
+
+        std::vector<GPUNode> nodes;
+        std::vector<uint32_t> order(instances.size());
+        for(uint32_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        if(!instances.empty())
+            buildBVH(nodes, order, boundsMin, boundsMax, 0, instances.size());
+
+        //instances are stored in BVH leaf order, so a leaf addresses a contiguous range
+        std::vector<GPUInstance> gpuInstances;
+        for(uint32_t i : order){
+            const Model &model = models[instances[i].model];
+            gpuInstances.push_back({glm::inverse(localToWorld[i]), glm::uvec4(model.base, model.octree->depth, i, 0)});
+        }
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceBufferID);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(gpuInstances.size(), 1) * sizeof(GPUInstance), gpuInstances.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, bvhBufferID);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(nodes.size(), 1) * sizeof(GPUNode), nodes.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        bvhSize = nodes.size();
+        instancesDirty = false;
+    }
+}
+
+//median split on the longest axis of the centroid bounds, returns the index of the node
+uint32_t InstanceScene::buildBVH(std::vector<GPUNode> &nodes, std::vector<uint32_t> &order, const std::vector<glm::vec3> &boundsMin, const std::vector<glm::vec3> &boundsMax, uint32_t begin, uint32_t end){
+    uint32_t index = nodes.size();
+    nodes.push_back(GPUNode());
+
+    glm::vec3 nodeMin(FLT_MAX), nodeMax(-FLT_MAX), centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+    for(uint32_t i = begin; i < end; i++){
+        nodeMin = glm::min(nodeMin, boundsMin[order[i]]);
+        nodeMax = glm::max(nodeMax, boundsMax[order[i]]);
+        glm::vec3 centroid = (boundsMin[order[i]] + boundsMax[order[i]]) * 0.5f;
+        centroidMin = glm::min(centroidMin, centroid);
+        centroidMax = glm::max(centroidMax, centroid);
+    }
+    nodes[index].boundsMin = glm::vec4(nodeMin, 0.0f);
+    nodes[index].boundsMax = glm::vec4(nodeMax, 0.0f);
+
+    if(end - begin <= BVH_LEAF_SIZE){
+        nodes[index].data = glm::uvec4(begin, end - begin, 1, 0);
+        return index;
+    }
+
+    glm::vec3 extent = centroidMax - centroidMin;
+    int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+    uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&](uint32_t a, uint32_t b){
+        return boundsMin[a][axis] + boundsMax[a][axis] < boundsMin[b][axis] + boundsMax[b][axis];
+    });
+
+    uint32_t left = buildBVH(nodes, order, boundsMin, boundsMax, begin, middle);
+    uint32_t right = buildBVH(nodes, order, boundsMin, boundsMax, middle, end);
+    nodes[index].data = glm::uvec4(left, right, 0, 0);
+    return index;
+}
+
+void InstanceScene::BindUniforms(uint8_t &texturesBound, const core::PassUniforms &uniforms){
+    glActiveTexture(GL_TEXTURE0 + texturesBound);
+    glBindTexture(GL_TEXTURE_BUFFER, modelTexBufferID);
+
+    glUniform1i(uniforms.location[core::MODEL_TEXTURE], (int)texturesBound);
+    glUniform1ui(uniforms.location[core::INSTANCE_COUNT], (GLuint)instances.size());
+    texturesBound++;
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, instanceBufferID);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, bvhBufferID);
+}
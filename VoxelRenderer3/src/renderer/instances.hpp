@@ -0,0 +1,67 @@
+#pragma once
+
+#include "core.hpp"
+#include "octree.hpp"
+
+#include <glm/mat4x4.hpp>
+
+// Top level of a two level acceleration structure. Instances place shared model octrees
+// in the world by a transform; moving one only rewrites its matrix and rebuilds the small
+// BVH over the instance bounds, the model voxels are stored once however often they are placed.
+class InstanceScene{
+    public:
+        struct Instance{
+            uint32_t model;
+            glm::mat4 transform;    //model leaf units to world leaf units, rotation and scale allowed
+        };
+
+        InstanceScene();
+        ~InstanceScene();
+
+        //models stay owned by the caller, edits made to them later are picked up on the next frame
+        uint32_t addModel(Octree *model);
+        uint32_t addInstance(uint32_t model, glm::mat4 transform);
+        void setTransform(uint32_t instance, glm::mat4 transform);
+
+        std::vector<Instance> instances;
+        uint32_t bvhSize = 0;
+
+        friend class Renderer;
+    private:
+        struct Model{
+            Octree *octree;
+            uint32_t base;      //first node in the shared model buffer
+            uint32_t revision;
+        };
+
+        //std430 layouts of InstanceBuffer and BVHBuffer in the ray shaders
+        struct GPUInstance{
+            glm::mat4 worldToLocal;
+            glm::uvec4 model;   //node base, depth, instance index
+        };
+
+        struct GPUNode{
+            glm::vec4 boundsMin;
+            glm::vec4 boundsMax;
+            glm::uvec4 data;    //left child or first instance, right child or count, leaf
+        };
+
+        std::vector<Model> models;
+        bool modelsDirty = false;
+        bool instancesDirty = false;
+
+        GLuint modelBufferID;
+        GLuint modelTexBufferID;
+        GLuint instanceBufferID;
+        GLuint bvhBufferID;
+        bool resident = false;
+        bool modified = true;
+
+        void GenBuffers();
+        void freeVRAM();
+        void Upload();
+        void BindUniforms(uint8_t &texturesBound, const core::PassUniforms &uniforms);
+
+        uint32_t buildBVH(std::vector<GPUNode> &nodes, std::vector<uint32_t> &order, const std::vector<glm::vec3> &boundsMin, const std::vector<glm::vec3> &boundsMax, uint32_t begin, uint32_t end);
+        static glm::mat4 shaderSpace(const glm::mat4 &transform);
+};
@@ -0,0 +1,218 @@
+#include "jobs.hpp"
+
+thread_local int32_t JobSystem::current = -1;
+
+JobSystem::JobSystem(Config config_){
+    threads = config_.threads;
+    if(threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    threads = std::max(threads, 1u);
+
+    queued = 0;
+    nextQueue = 0;
+    executed = 0;
+    stolen = 0;
+    mainThread = std::this_thread::get_id();
+    sampledAt = std::chrono::steady_clock::now();
+
+    for(uint32_t i = 0; i <= threads; i++){
+        workers.emplace_back(new Worker());
+        workers.back()->busyNs = 0;
+    }
+    for(uint32_t i = 0; i < threads; i++)
+        workers[i]->thread = std::thread(&JobSystem::loop, this, i);
+}
+
+JobSystem::~JobSystem(){
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    sleep.notify_all();
+    for(uint32_t i = 0; i < threads; i++)
+        workers[i]->thread.join();
+}
+
+JobSystem::Handle JobSystem::create(std::function<void()> work){
+    Handle job = std::make_shared<Job>();
+    job->work = std::move(work);
+    job->pending = 1;
+    job->done = false;
+    return job;
+}
+
+void JobSystem::depend(const Handle &then, const Handle &first){
+    std::lock_guard<std::mutex> guard(first->lock);
+    if(first->done)
+        return;
+    then->pending++;
+    first->continuations.push_back(then);
+}
+
+JobSystem::Handle JobSystem::submit(const Handle &job){
+    if(--job->pending == 0)
+        enqueue(job);
+    return job;
+}
+
+JobSystem::Handle JobSystem::run(std::function<void()> work){
+    return submit(create(std::move(work)));
+}
+
+bool JobSystem::finished(const Handle &job) const{
+    return job->done;
+}
+
+void JobSystem::wait(const Handle &job){
+    uint32_t index = current >= 0 ? (uint32_t)current : threads;
+    bool onMain = std::this_thread::get_id() == mainThread;
+    while(!job->done){
+        if(onMain)
+            drainMain();
+        if(!runOne(index))
+            std::this_thread::yield();
+    }
+}
+
+//workers push where they run so their own follow up work stays warm, other threads round robin
+void JobSystem::enqueue(const Handle &job){
+    uint32_t index = current >= 0 ? (uint32_t)current : nextQueue++ % (threads + 1);
+    {
+        std::lock_guard<std::mutex> guard(workers[index]->lock);
+        workers[index]->jobs.push_back(job);
+        queued++;
+    }
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+    }
+    sleep.notify_one();
+}
+
+bool JobSystem::runOne(uint32_t index){
+    Handle job;
+    {
+        Worker &own = *workers[index];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if(!own.jobs.empty()){
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            queued--;
+        }
+    }
+
+    //steals the oldest job of the first busy queue, the least likely to share data with its owner's current one
+    for(uint32_t i = 1; !job && i <= threads; i++){
+        Worker &victim = *workers[(index + i) % (threads + 1)];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if(!victim.jobs.empty()){
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            queued--;
+            stolen++;
+        }
+    }
+
+    if(!job)
+        return false;
+    execute(job, index);
+    return true;
+}
+
+void JobSystem::execute(const Handle &job, uint32_t index){
+    auto start = std::chrono::steady_clock::now();
+    job->work();
+    workers[index]->busyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    executed++;
+
+    std::vector<Handle> ready;
+    {
+        std::lock_guard<std::mutex> guard(job->lock);
+        job->done = true;
+        ready.swap(job->continuations);
+    }
+    for(const Handle &next : ready)
+        if(--next->pending == 0)
+            enqueue(next);
+}
+
+void JobSystem::loop(uint32_t index){
+    current = index;
+    std::string name = "worker " + std::to_string(index);
+    Profiler::setThreadName(name.c_str());
+    while(true){
+        if(runOne(index))
+            continue;
+
+        std::unique_lock<std::mutex> guard(sleepLock);
+        sleep.wait(guard, [this](){ return stopping || queued > 0; });
+        if(stopping && queued == 0)
+            return;
+    }
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)> &body){
+    grain = std::max<size_t>(grain, 1);
+    if(count <= grain){
+        if(count > 0)
+            body(0, count);
+        return;
+    }
+
+    std::vector<Handle> jobs;
+    for(size_t begin = 0; begin < count; begin += grain){
+        size_t end = std::min(begin + grain, count);
+        jobs.push_back(run([&body, begin, end](){ body(begin, end); }));
+    }
+    for(const Handle &job : jobs)
+        wait(job);
+}
+
+void JobSystem::parallelFor(glm::uvec3 min, glm::uvec3 max, glm::uvec3 grain, const std::function<void(glm::uvec3, glm::uvec3)> &body){
+    if(max.x <= min.x || max.y <= min.y || max.z <= min.z)
+        return;
+    grain = glm::max(grain, glm::uvec3(1));
+    glm::uvec3 blocks = (max - min + grain - glm::uvec3(1)) / grain;
+
+    parallelFor((size_t)blocks.x * blocks.y * blocks.z, 1, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            glm::uvec3 block((uint32_t)(i / ((size_t)blocks.y * blocks.z)), (uint32_t)((i / blocks.z) % blocks.y), (uint32_t)(i % blocks.z));
+            glm::uvec3 blockMin = min + block * grain;
+            body(blockMin, glm::min(blockMin + grain, max));
+        }
+    });
+}
+
+uint32_t JobSystem::worker() const{
+    return current >= 0 ? (uint32_t)current : threads;
+}
+
+void JobSystem::runOnMain(std::function<void()> work){
+    std::lock_guard<std::mutex> guard(mainLock);
+    mainJobs.push_back(std::move(work));
+}
+
+uint32_t JobSystem::drainMain(){
+    std::vector<std::function<void()>> work;
+    {
+        std::lock_guard<std::mutex> guard(mainLock);
+        work.swap(mainJobs);
+    }
+    for(std::function<void()> &w : work)
+        w();
+    return work.size();
+}
+
+void JobSystem::profile(core::DebugInfo &debug){
+    auto now = std::chrono::steady_clock::now();
+    double elapsedNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(now - sampledAt).count();
+    sampledAt = now;
+
+    debug.worker_utilization.resize(threads);
+    for(uint32_t i = 0; i < threads; i++){
+        uint64_t busy = workers[i]->busyNs;
+        debug.worker_utilization[i] = elapsedNs <= 0.0 ? 0.0f : (float)std::min((double)(busy - workers[i]->sampledNs) / elapsedNs, 1.0);
+        workers[i]->sampledNs = busy;
+    }
+    debug.jobs_executed = executed;
+    debug.jobs_stolen = stolen;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "core.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
+
+// Engine wide thread pool. Every worker owns a deque it pushes to and pops from the back of,
+// idle workers steal from the front of the others. Jobs can be chained into graphs: a job
+// only becomes runnable once every job it depends on has finished. GL calls can't be made
+// from workers, so jobs hand them to the main thread queue, drained once per frame.
+class JobSystem{
+    public:
+        struct Config{
+            uint32_t threads;   //workers, 0 leaves one hardware thread to the main thread
+        };
+
+        class Job{
+            public:
+                friend class JobSystem;
+            private:
+                std::function<void()> work;
+                std::atomic<uint32_t> pending;  //unfinished dependencies, plus one until submitted
+                std::atomic<bool> done;
+                std::mutex lock;                //guards continuations against a dependency finishing
+                std::vector<std::shared_ptr<Job>> continuations;
+        };
+        typedef std::shared_ptr<Job> Handle;
+
+        explicit JobSystem(Config config_);
+        ~JobSystem();
+
+        Handle create(std::function<void()> work);
+        //then only starts after first has finished, both must not have been submitted yet
+        void depend(const Handle &then, const Handle &first);
+        Handle submit(const Handle &job);
+        Handle run(std::function<void()> work);
+        bool finished(const Handle &job) const;
+        //runs other jobs (and main thread work when called from it) until job has finished
+        void wait(const Handle &job);
+
+        //blocking, body gets [begin, end) ranges of at most grain items
+        void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)> &body);
+        //blocking, body gets [min, max) blocks of at most grain cells
+        void parallelFor(glm::uvec3 min, glm::uvec3 max, glm::uvec3 grain, const std::function<void(glm::uvec3, glm::uvec3)> &body);
+
+        void runOnMain(std::function<void()> work);
+        //runs everything queued for the main thread, returns the amount of work run
+        uint32_t drainMain();
+
+        //fraction of the time every worker spent running jobs since the previous call
+        void profile(core::DebugInfo &debug);
+
+        //scratch slot of the calling thread in [0, threads], threads outside the pool share the last one
+        uint32_t worker() const;
+
+        uint32_t threads;
+
+    private:
+        struct Worker{
+            std::thread thread;
+            std::mutex lock;
+            std::deque<Handle> jobs;
+            std::atomic<uint64_t> busyNs;
+            uint64_t sampledNs = 0;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;   //the last one belongs to threads that aren't workers
+        std::atomic<uint32_t> queued;
+        std::atomic<uint32_t> nextQueue;
+        std::atomic<uint64_t> executed, stolen;
+        std::mutex sleepLock;
+        std::condition_variable sleep;
+        bool stopping = false;
+
+        std::mutex mainLock;
+        std::vector<std::function<void()>> mainJobs;
+        std::thread::id mainThread;
+
+        std::chrono::steady_clock::time_point sampledAt;
+
+        static thread_local int32_t current;   //worker index of the calling thread, -1 outside the pool
+
+        void loop(uint32_t index);
+        void enqueue(const Handle &job);
+        bool runOne(uint32_t index);
+        void execute(const Handle &job, uint32_t index);
+};
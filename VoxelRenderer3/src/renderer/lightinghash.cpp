@@ -0,0 +1,130 @@
+#include "lightinghash.hpp"
+
+LightingHashTable::LightingHashTable(Config config_) : config(config_){
+    config.width = floorPow2(config.width);
+    config.rows = floorPow2(config.rows);
+    config.maxProbe = config.maxProbe == 0 ? 1 : config.maxProbe;
+    capacity = config.width * config.rows;
+    clear();
+}
+
+float LightingHashTable::Stats::loadFactor(uint32_t capacity) const{
+    return capacity == 0 ? 0.0f : (float)occupied / (float)capacity;
+}
+
+float LightingHashTable::Stats::evictionRate() const{
+    return lookups == 0 ? 0.0f : (float)evictions / (float)lookups;
+}
+
+float LightingHashTable::Stats::failureRate() const{
+    return lookups == 0 ? 0.0f : (float)failures / (float)lookups;
+}
+
+float LightingHashTable::Stats::averageProbe() const{
+    uint64_t resolved = 0, probes = 0;
+    for(size_t i = 0; i < probeHistogram.size(); i++){
+        resolved += probeHistogram[i];
+        probes += probeHistogram[i] * i;
+    }
+    return resolved == 0 ? 0.0f : (float)probes / (float)resolved;
+}
+
+//lowbias32, must match hash() in accum.comp and avg.comp
+uint32_t LightingHashTable::hash(uint32_t key){
+    key ^= key >> 16;
+    key *= 0x7feb352dU;
+    key ^= key >> 15;
+    key *= 0x846ca68bU;
+    key ^= key >> 16;
+    return key;
+}
+
+uint32_t LightingHashTable::floorPow2(uint32_t x){
+    if(x == 0) return 1;
+    uint32_t p = 1;
+    while(p <= x >> 1) p <<= 1;
+    return p;
+}
+
+uint32_t LightingHashTable::log2(uint32_t x){
+    uint32_t l = 0;
+    while(x >>= 1) l++;
+    return l;
+}
+
+void LightingHashTable::clear(){
+    keys.assign(capacity, 0);
+    times.assign(capacity, 0);
+    stats = Stats();
+    stats.probeHistogram.assign(config.maxProbe, 0);
+}
+
+int64_t LightingHashTable::access(uint32_t key, uint32_t time){
+    stats.lookups++;
+    uint32_t mask = capacity - 1;
+    uint32_t h = hash(key);
+
+    int64_t oldest = -1;
+    uint32_t oldestTime = UINT32_MAX;
+
+    for(uint32_t i = 0; i < config.maxProbe; i++){
+        uint32_t entry = (h + i) & mask;
+        if(keys[entry] == 0){
+            keys[entry] = key;
+            stats.claims++;
+            stats.occupied++;
+        }
+        if(keys[entry] == key){
+            times[entry] = time;
+            stats.probeHistogram[i]++;
+            return entry;
+        }
+        if(times[entry] < oldestTime){
+            oldestTime = times[entry];
+            oldest = entry;
+        }
+    }
+
+    if(oldest >= 0 && time > oldestTime + config.evictAge){
+        keys[oldest] = key;
+        times[oldest] = time;
+        stats.evictions++;
+        stats.probeHistogram[config.maxProbe - 1]++;
+        return oldest;
+    }
+
+    stats.failures++;
+    return -1;
+}
+
+void LightingHashTable::simulate(const std::vector<uint32_t> &frameKeys, uint32_t time){
+    for(uint32_t key : frameKeys)
+        if(key != 0)
+            access(key, time);
+}
+
+bool LightingHashTable::loadStream(const char *path, std::vector<std::vector<uint32_t>> &frames){
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open())
+        return false;
+
+    uint32_t count;
+    while(file.read((char*)&count, sizeof(count))){
+        std::vector<uint32_t> frameKeys(count);
+        if(!file.read((char*)frameKeys.data(), count * sizeof(uint32_t)))
+            return false;
+        frames.push_back(std::move(frameKeys));
+    }
+    return true;
+}
+
+bool LightingHashTable::appendStream(const char *path, const std::vector<uint32_t> &frameKeys){
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if(!file.is_open())
+        return false;
+
+    uint32_t count = frameKeys.size();
+    file.write((const char*)&count, sizeof(count));
+    file.write((const char*)frameKeys.data(), count * sizeof(uint32_t));
+    return file.good();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core.hpp"
+
+// CPU model of the lighting buffer hash table driven by accum.comp and avg.comp.
+// It follows the same hashing, probing, claiming and eviction rules, so the table
+// can be sized and tuned on recorded voxel ID streams without touching the GPU.
+class LightingHashTable{
+    public:
+        struct Config{
+            uint32_t width;     //entries per texture row, power of two
+            uint32_t rows;      //rows of entries, power of two
+            uint32_t maxProbe;  //longest probe sequence before giving up
+            uint32_t evictAge;  //entries untouched for longer than this may be replaced
+        };
+
+        struct Stats{
+            uint64_t lookups = 0;
+            uint64_t claims = 0;
+            uint64_t evictions = 0;
+            uint64_t failures = 0;
+            uint32_t occupied = 0;
+            std::vector<uint64_t> probeHistogram; //resolved lookups by probe length
+
+            float loadFactor(uint32_t capacity) const;
+            float evictionRate() const;
+            float failureRate() const;
+            float averageProbe() const;
+        };
+
+        explicit LightingHashTable(Config config_);
+
+        static uint32_t hash(uint32_t key);
+        static uint32_t floorPow2(uint32_t x);
+        static uint32_t log2(uint32_t x);
+
+        //returns the entry owned by key after the access, -1 when the probe window is full
+        int64_t access(uint32_t key, uint32_t time);
+        void simulate(const std::vector<uint32_t> &frameKeys, uint32_t time);
+        void clear();
+
+        //recorded streams are a sequence of frames, each a uint32 count followed by that many keys
+        static bool loadStream(const char *path, std::vector<std::vector<uint32_t>> &frames);
+        static bool appendStream(const char *path, const std::vector<uint32_t> &frameKeys);
+
+        Config config;
+        uint32_t capacity;
+        Stats stats;
+
+    private:
+        std::vector<uint32_t> keys;
+        std::vector<uint32_t> times;
+};
@@ -1,50 +1,77 @@
-#include "material.hpp"
-#define UBO_SIZE 64
-
-MaterialPool::MaterialPool() : length(1){
-    capacity = 1<<7;
-}
-
-void MaterialPool::setProgram(GLuint program_){
-    program = program_;
-    GLuint material_index = glGetUniformBlockIndex(program, "MaterialUniform");   
-    glUniformBlockBinding(program, material_index, 1);
-}
-
-void MaterialPool::GenUBO(GLuint program_){
-    program = program_;
-    GLuint material_index = glGetUniformBlockIndex(program, "MaterialUniform");   
-    glUniformBlockBinding(program, material_index, 1);
-    
-    glGenBuffers(1, &gl_ID);
-    glBindBuffer(GL_UNIFORM_BUFFER, gl_ID);
-    glBufferData(GL_UNIFORM_BUFFER, capacity * UBO_SIZE, NULL, GL_STATIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-
-    glBindBufferBase(GL_UNIFORM_BUFFER, 1, gl_ID);
-}
-
-void MaterialPool::freeVRAM(){
-    glDeleteBuffers(1, &gl_ID); 
-}
-
-MaterialPool::~MaterialPool(){
-    freeVRAM();
-}
-
-uint32_t MaterialPool::addMaterial(Material *material){
-    glBindBuffer(GL_UNIFORM_BUFFER, gl_ID);
-    glBufferSubData(GL_UNIFORM_BUFFER, length * UBO_SIZE, UBO_SIZE, material);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-    length++;
-    return length-1;
-}
-
-bool MaterialPool::setMaterial(Material *material, uint32_t index){
-    if(index == 0 || index >= length)
-        return false;
-    glBindBuffer(GL_UNIFORM_BUFFER, gl_ID);
-    glBufferSubData(GL_UNIFORM_BUFFER, index * UBO_SIZE, UBO_SIZE, material);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-    return true;
-}
\ No newline at end of file
+#include "material.hpp"
+#include <algorithm>
+
+#define MATERIAL_BINDING 1          //std430 MaterialBuffer
+#define MAX_MATERIALS (1u << 13)    //width of Octree::Node::leaf.material
+
+MaterialPool::MaterialPool() : length(1){
+    capacity = 1<<8;
+    //entry 0 is "no material"
+    materials.resize(1, PackedMaterial{});
+    dirtyEnd = 1;
+}
+
+void MaterialPool::GenBuffers(){
+    glGenBuffers(1, &gl_ID);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MATERIAL_BINDING, gl_ID);
+    Upload();
+}
+
+//the binding refers to the buffer object, so it survives the storage being reallocated
+void MaterialPool::Upload(){
+    if(dirtyEnd <= dirtyBegin)
+        return;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, gl_ID);
+    if(bufferCapacity < capacity){
+        glBufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(PackedMaterial), NULL, GL_STATIC_DRAW);
+        bufferCapacity = capacity;
+        dirtyBegin = 0;
+        dirtyEnd = length;
+    }
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, dirtyBegin * sizeof(PackedMaterial), (dirtyEnd - dirtyBegin) * sizeof(PackedMaterial), materials.data() + dirtyBegin);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    dirtyBegin = dirtyEnd = 0;
+}
+
+void MaterialPool::freeVRAM(){
+    glDeleteBuffers(1, &gl_ID); 
+    gl_ID = 0;
+    bufferCapacity = 0;
+}
+
+MaterialPool::~MaterialPool(){
+    freeVRAM();
+}
+
+PackedMaterial MaterialPool::pack(const Material &material){
+    auto unorm8 = [](float value){ return (uint32_t)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f); };
+    return {
+        .color = glm::vec3(material.color),
+        .emissiveIntensity = material.emissive ? material.emissiveIntensity : 0.0f,
+        .specularColor = glm::vec3(material.specularColor),
+        .params = unorm8(material.diffuse) | unorm8(material.specular) << 8 | unorm8(material.metallic) << 16 | (material.emissive ? 255u : 0u) << 24
+    };
+}
+
+uint32_t MaterialPool::addMaterial(Material *material){
+    if(length >= MAX_MATERIALS)
+        return 0;
+    if(length >= capacity)
+        capacity = std::min(capacity * 2, MAX_MATERIALS);
+    materials.push_back(pack(*material));
+    dirtyBegin = dirtyEnd > dirtyBegin ? std::min(dirtyBegin, length) : length;
+    dirtyEnd = length + 1;
+    modified = true;
+    length++;
+    return length-1;
+}
+
+bool MaterialPool::setMaterial(Material *material, uint32_t index){
+    if(index == 0 || index >= length)
+        return false;
+    materials[index] = pack(*material);
+    dirtyBegin = dirtyEnd > dirtyBegin ? std::min(dirtyBegin, index) : index;
+    dirtyEnd = std::max(dirtyEnd, index + 1);
+    modified = true;
+    return true;
+}
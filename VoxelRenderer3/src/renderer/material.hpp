@@ -1,45 +1,67 @@
-#pragma once
-
-#include <stack>
-#include <functional>
-#include <cstdlib>
-
-#include <glad/glad.h>
-
-#define GL_SILENCE_DEPRECATION
-#if defined(IMGUI_IMPL_OPENGL_ES2)
-#include <GLES2/gl2.h>
-#endif
-#include <GLFW/glfw3.h> // Will drag system OpenGL headers
-
-#include <glm/vec4.hpp>
-
-struct Material{
-    glm::vec4 color;            //16 
-    glm::vec4 specularColor;    //16
-    float diffuse;              //4 
-    float specular;             //4 
-    float metallic;             //4 
-    bool emissive = false;      //4
-    float emissiveIntensity;    //4
-};
-
-class MaterialPool{
-    public:
-        MaterialPool();
-        ~MaterialPool();
-        uint32_t addMaterial(Material *material);
-        bool setMaterial(Material *material, uint32_t index);
-
-        uint32_t length;
-        uint32_t capacity;
-
-        friend class Renderer;
-    private:
-        void setProgram(GLuint program_);
-        void GenUBO(GLuint program_);
-        void freeVRAM();
-
-        GLuint gl_ID;
-        GLuint program;
-};
\ No newline at end of file
+#pragma once
+
+#include <stack>
+#include <functional>
+#include <cstdlib>
+
+#include <glad/glad.h>
+
+#define GL_SILENCE_DEPRECATION
+#if defined(IMGUI_IMPL_OPENGL_ES2)
+#include <GLES2/gl2.h>
+#endif
+#include <GLFW/glfw3.h> // Will drag system OpenGL headers
+
+#include <glm/vec4.hpp>
+
+#include <glm/vec3.hpp>
+#include <vector>
+
+//how materials are authored, MaterialPool packs them into PackedMaterial for the GPU
+struct Material{
+    glm::vec4 color;
+    glm::vec4 specularColor;
+    float diffuse;
+    float specular;
+    float metallic;
+    bool emissive = false;
+    float emissiveIntensity;
+};
+
+//one std430 MaterialBuffer entry, two 16 byte loads per lookup in the shaders
+struct PackedMaterial{
+    glm::vec3 color;            //0
+    float emissiveIntensity;    //12, 0 unless emissive
+    glm::vec3 specularColor;    //16
+    uint32_t params;            //28, diffuse, specular, metallic and the emissive flag as unorm8
+};
+static_assert(sizeof(PackedMaterial) == 32, "PackedMaterial has to match the std430 MaterialBuffer layout");
+
+// Materials are edited on the CPU copy, the range touched since the last frame is uploaded
+// with a single glBufferSubData. The pool starts at 256 entries and doubles up to the 13 bit
+// leaf material index, reallocating the storage buffer on the next upload.
+class MaterialPool{
+    public:
+        MaterialPool();
+        ~MaterialPool();
+        uint32_t addMaterial(Material *material);   //0 (no material) once the pool is full
+        bool setMaterial(Material *material, uint32_t index);
+
+        uint32_t length;
+        uint32_t capacity;
+
+        friend class Renderer;
+    private:
+        void GenBuffers();
+        void Upload();
+        void freeVRAM();
+
+        static PackedMaterial pack(const Material &material);
+
+        GLuint gl_ID = 0;
+        uint32_t bufferCapacity = 0;    //entries allocated on the GPU
+        std::vector<PackedMaterial> materials;
+        uint32_t dirtyBegin = 0, dirtyEnd = 0;
+
+        bool modified = true;
+};
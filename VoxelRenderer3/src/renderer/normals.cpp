@@ -0,0 +1,142 @@
+#include "normals.hpp"
+
+#include <cmath>
+
+NormalBaker::NormalBaker(Config config_, JobSystem *jobs_) : config(config_), jobs(jobs_){
+    config.radius = std::max(config.radius, 1u);
+    config.tile = std::max(config.tile, 1u);
+
+    //pascal's triangle row, normalized
+    weights.assign(1, 1.0f);
+    for(uint32_t i = 0; i < 2 * config.radius; i++){
+        std::vector<float> next(weights.size() + 1, 0.0f);
+        for(size_t j = 0; j < weights.size(); j++){
+            next[j] += weights[j];
+            next[j + 1] += weights[j];
+        }
+        weights.swap(next);
+    }
+    float sum = 0.0f;
+    for(float w : weights)
+        sum += w;
+    for(float &w : weights)
+        w /= sum;
+}
+
+//tile jobs read the octree through its own pointer
+NormalBaker::~NormalBaker(){
+    for(Tile &tile : tiles)
+        jobs->wait(tile.job);
+}
+
+uint32_t NormalBaker::pending() const{
+    return tiles.size();
+}
+
+uint32_t NormalBaker::update(Octree *volume){
+    uint32_t changed = 0;
+    while(!tiles.empty() && jobs->finished(tiles.front().job)){
+        changed += volume->setNormals(*tiles.front().normals);
+        tiles.pop_front();
+    }
+
+    std::vector<Octree::Region> regions;
+    if(!volume->consumeDirtyRegions(regions))
+        return changed;
+
+    //a leaf's estimate reads occupancy up to radius + 1 away, so that far from an edit normals change
+    uint32_t reach = config.radius + 1;
+    uint32_t length = 1u << volume->depth;
+    for(const Octree::Region &region : regions){
+        glm::uvec3 min = glm::uvec3(glm::max(glm::ivec3(region.min) - glm::ivec3(reach), glm::ivec3(0)));
+        glm::uvec3 max = glm::min(region.max + glm::uvec3(reach), glm::uvec3(length - 1));
+        for(uint32_t x = min.x; x <= max.x; x += config.tile){
+            for(uint32_t y = min.y; y <= max.y; y += config.tile){
+                for(uint32_t z = min.z; z <= max.z; z += config.tile){
+                    glm::uvec3 tileMin(x, y, z);
+                    glm::uvec3 tileMax = glm::min(tileMin + glm::uvec3(config.tile - 1), max);
+                    std::shared_ptr<Normals> normals = std::make_shared<Normals>();
+                    JobSystem::Handle job = jobs->run([this, volume, tileMin, tileMax, normals](){
+                        estimate(volume, tileMin, tileMax, *normals);
+                    });
+                    tiles.push_back({job, normals});
+                }
+            }
+        }
+    }
+    return changed;
+}
+
+void NormalBaker::estimate(const Octree *volume, glm::uvec3 min, glm::uvec3 max, Normals &normals) const{
+    PROFILE_ZONE("NormalBaker::estimate");
+    int32_t length = 1 << volume->depth;
+    int32_t reach = (int32_t)config.radius + 1;
+    glm::ivec3 brickMin = glm::max(glm::ivec3(min) - glm::ivec3(reach), glm::ivec3(0));
+    glm::ivec3 brickMax = glm::min(glm::ivec3(max) + glm::ivec3(reach), glm::ivec3(length - 1));
+    glm::ivec3 size = brickMax - brickMin + glm::ivec3(1);
+    auto cell = [&](glm::ivec3 p){ return ((size_t)p.x * size.y + p.y) * size.z + p.z; };
+
+    std::vector<glm::uvec3> solid;
+    volume->overlapAABB(glm::vec3(brickMin), glm::vec3(brickMax + glm::ivec3(1)), &solid);
+    std::vector<float> occupancy((size_t)size.x * size.y * size.z, 0.0f);
+    for(const glm::uvec3 &leaf : solid)
+        occupancy[cell(glm::ivec3(leaf) - brickMin)] = 1.0f;
+
+    //one axis at a time, outside the world counts as empty
+    std::vector<float> smooth = occupancy, pass(occupancy.size());
+    int32_t radius = (int32_t)config.radius;
+    for(int a = 0; a < 3; a++){
+        for(int32_t x = 0; x < size.x; x++){
+            for(int32_t y = 0; y < size.y; y++){
+                for(int32_t z = 0; z < size.z; z++){
+                    glm::ivec3 p(x, y, z);
+                    float sum = 0.0f;
+                    for(int32_t k = -radius; k <= radius; k++){
+                        glm::ivec3 q = p;
+                        q[a] += k;
+                        if(q[a] >= 0 && q[a] < size[a])
+                            sum += weights[k + radius] * smooth[cell(q)];
+                    }
+                    pass[cell(p)] = sum;
+                }
+            }
+        }
+        smooth.swap(pass);
+    }
+
+    auto sample = [&](const std::vector<float> &field, glm::ivec3 p){
+        if(p.x < 0 || p.y < 0 || p.z < 0 || p.x >= size.x || p.y >= size.y || p.z >= size.z)
+            return 0.0f;
+        return field[cell(p)];
+    };
+    for(const glm::uvec3 &leaf : solid){
+        if(leaf.x < min.x || leaf.y < min.y || leaf.z < min.z || leaf.x > max.x || leaf.y > max.y || leaf.z > max.z)
+            continue;
+        glm::ivec3 p = glm::ivec3(leaf) - brickMin;
+
+        //buried leaves are never seen, open faces are the fallback where the gradient cancels out
+        glm::vec3 gradient(0.0f), open(0.0f);
+        for(int a = 0; a < 3; a++){
+            glm::ivec3 offset(0);
+            offset[a] = 1;
+            gradient[a] = sample(smooth, p + offset) - sample(smooth, p - offset);
+            open[a] = sample(occupancy, p - offset) - sample(occupancy, p + offset);
+            if(sample(occupancy, p + offset) == 0.0f && sample(occupancy, p - offset) == 0.0f)
+                open[a] = 0.0f;
+        }
+        bool surface = false;
+        for(int a = 0; a < 3 && !surface; a++){
+            glm::ivec3 offset(0);
+            offset[a] = 1;
+            surface = sample(occupancy, p + offset) == 0.0f || sample(occupancy, p - offset) == 0.0f;
+        }
+        if(!surface)
+            continue;
+
+        glm::vec3 normal = glm::length(gradient) > 1e-4f ? -gradient : open;
+        if(glm::length(normal) < 1e-4f)
+            continue;
+        normal = glm::normalize(normal);
+        normals.push_back({leaf, Octree::packedNormal(normal)});
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core.hpp"
+#include "octree.hpp"
+#include "jobs.hpp"
+
+#include <deque>
+#include <memory>
+
+// Re-estimates leaf normals near edits in the background. Insert time normals come from the
+// generator's shapes and go stale next to later inserts and removals. The dirty regions of the
+// octree, grown by the filter reach, are split into tiles. A job per tile smooths a dense
+// occupancy brick with a separable binomial filter and takes the negated gradient at every
+// surface leaf. Finished tiles are patched in on the main thread, edits never wait for them.
+class NormalBaker{
+    public:
+        struct Config{
+            uint32_t radius;    //half width of the binomial filter in leaves
+            uint32_t tile;      //leaves per side of the block one job estimates
+        };
+
+        NormalBaker(Config config_, JobSystem *jobs_);
+        ~NormalBaker();
+
+        //patches the tiles finished since the last call and starts jobs for new edits, returns the amount of normals changed
+        uint32_t update(Octree *volume);
+        //tiles queued or running
+        uint32_t pending() const;
+
+        Config config;
+
+    private:
+        typedef std::vector<std::pair<glm::uvec3, uint32_t>> Normals;
+
+        struct Tile{
+            JobSystem::Handle job;
+            std::shared_ptr<Normals> normals;
+        };
+
+        JobSystem *jobs;
+        std::vector<float> weights;     //binomial, 2 * radius + 1 taps
+        std::deque<Tile> tiles;
+
+        //surface leaves inside [min, max] and their packed normals
+        void estimate(const Octree *volume, glm::uvec3 min, glm::uvec3 max, Normals &normals) const;
+};
@@ -0,0 +1,108 @@
+#include "occlusion.hpp"
+
+#include <cmath>
+
+OcclusionBaker::OcclusionBaker(Config config_, JobSystem *jobs_) : config(config_), jobs(jobs_){
+    config.rays = config.rays == 0 ? 1 : config.rays;
+
+    //fibonacci spiral over the disk projected up to the hemisphere, cosine distributed and the same for every leaf
+    const float goldenAngle = 2.39996323f;
+    for(uint32_t i = 0; i < config.rays; i++){
+        float u = ((float)i + 0.5f) / (float)config.rays;
+        float r = std::sqrt(u);
+        float phi = (float)i * goldenAngle;
+        directions.push_back(glm::vec3(r * std::cos(phi), r * std::sin(phi), std::sqrt(1.0f - u)));
+    }
+}
+
+bool OcclusionBaker::solid(Octree *volume, glm::ivec3 position){
+    int32_t length = 1 << volume->depth;
+    if(position.x < 0 || position.y < 0 || position.z < 0 || position.x >= length || position.y >= length || position.z >= length)
+        return false;
+    Octree::Node node = volume->data[volume->lookup(glm::uvec3(position))];
+    return !node.base.isNode && node.leaf.material != 0;
+}
+
+uint8_t OcclusionBaker::visibility(Octree *volume, glm::ivec3 position, glm::vec3 normal){
+    glm::vec3 tangent = glm::normalize(glm::cross(normal, std::abs(normal.y) < 0.99f ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0)));
+    glm::vec3 bitangent = glm::cross(normal, tangent);
+    glm::vec3 origin = glm::vec3(position) + glm::vec3(0.5f);
+
+    float occlusion = 0.0f;
+    for(const glm::vec3 &d : directions){
+        glm::vec3 direction = tangent * d.x + bitangent * d.y + normal * d.z;
+
+        //voxel DDA, the leaf itself is skipped and closer hits occlude more
+        glm::ivec3 cell = position;
+        glm::ivec3 step(direction.x < 0 ? -1 : 1, direction.y < 0 ? -1 : 1, direction.z < 0 ? -1 : 1);
+        glm::vec3 delta, next;
+        for(int a = 0; a < 3; a++){
+            delta[a] = direction[a] == 0.0f ? 1e30f : std::abs(1.0f / direction[a]);
+            float boundary = step[a] > 0 ? (float)(cell[a] + 1) : (float)cell[a];
+            next[a] = direction[a] == 0.0f ? 1e30f : (boundary - origin[a]) / direction[a];
+        }
+
+        float t = 0.0f;
+        while(t < config.radius){
+            int a = next.x < next.y ? (next.x < next.z ? 0 : 2) : (next.y < next.z ? 1 : 2);
+            t = next[a];
+            cell[a] += step[a];
+            next[a] += delta[a];
+            if(t < config.radius && solid(volume, cell)){
+                occlusion += 1.0f - t / config.radius;
+                break;
+            }
+        }
+    }
+
+    float visible = 1.0f - occlusion / (float)directions.size();
+    return (uint8_t)std::round(glm::clamp(visible, 0.0f, 1.0f) * 255.0f);
+}
+
+uint32_t OcclusionBaker::update(Octree *volume){
+    glm::uvec3 min, max;
+    if(!volume->consumeEdits(min, max))
+        return 0;
+
+    //an edit changes the occlusion of every leaf that can reach it
+    uint32_t reach = (uint32_t)std::ceil(config.radius);
+    min = glm::uvec3(glm::max(glm::ivec3(min) - glm::ivec3(reach), glm::ivec3(0)));
+    max = max + glm::uvec3(reach);
+    return bake(volume, min, max);
+}
+
+uint32_t OcclusionBaker::bake(Octree *volume, glm::uvec3 min, glm::uvec3 max){
+    PROFILE_ZONE("OcclusionBaker::bake");
+    std::vector<glm::uvec4> region;
+    volume->forEachLeaf({min, max}, [&](const Octree::Leaf &leaf){
+        region.push_back(glm::uvec4(leaf.index, leaf.position.x, leaf.position.y, leaf.position.z));
+    });
+
+    //workers only read the tree, results are written back on this thread so the dirty range stays consistent
+    std::vector<uint8_t> results(region.size(), 255);
+    jobs->parallelFor(region.size(), 64, [&](size_t begin, size_t end){
+        PROFILE_ZONE("occlusion rays");
+        for(size_t i = begin; i < end; i++){
+            glm::ivec3 position(region[i].y, region[i].z, region[i].w);
+            bool surface = false;
+            for(int a = 0; a < 3 && !surface; a++){
+                glm::ivec3 offset(0);
+                offset[a] = 1;
+                surface = !solid(volume, position + offset) || !solid(volume, position - offset);
+            }
+            //buried leaves are never seen
+            if(!surface)
+                continue;
+
+            glm::vec3 normal = Octree::unpackedNormal(volume->data[region[i].x].leaf.normal);
+            if(glm::length(normal) < 0.1f)
+                continue;
+            results[i] = visibility(volume, position, glm::normalize(normal));
+        }
+    });
+
+    for(size_t i = 0; i < region.size(); i++)
+        volume->setOcclusion(region[i].x, results[i]);
+
+    return region.size();
+}
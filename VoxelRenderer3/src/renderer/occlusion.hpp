@@ -0,0 +1,32 @@
+#pragma once
+
+#include "core.hpp"
+#include "octree.hpp"
+#include "jobs.hpp"
+
+// Bakes per voxel ambient occlusion on the CPU: every surface leaf casts a fixed set
+// of cosine distributed hemisphere rays through the octree and stores its quantized
+// visibility in Octree::occlusion. Only leaves near the last edits are rebaked.
+class OcclusionBaker{
+    public:
+        struct Config{
+            uint32_t rays;      //hemisphere rays per leaf
+            float radius;       //occluders further away than this (in leaves) are ignored
+        };
+
+        OcclusionBaker(Config config_, JobSystem *jobs_);
+
+        //rebakes the leaves near everything edited since the last call, returns the amount of leaves baked
+        uint32_t update(Octree *volume);
+        //rebakes every leaf inside [min, max]
+        uint32_t bake(Octree *volume, glm::uvec3 min, glm::uvec3 max);
+
+        Config config;
+
+    private:
+        JobSystem *jobs;
+        std::vector<glm::vec3> directions;   //around +z, rotated onto the leaf normal
+
+        static bool solid(Octree *volume, glm::ivec3 position);
+        uint8_t visibility(Octree *volume, glm::ivec3 position, glm::vec3 normal);
+};
@@ -1,174 +1,1123 @@
-#include "octree.hpp"
-#include "iostream"
-
-Octree::Octree(Config *config){
-    depth = config->depth > maxDepth ? maxDepth : config->depth;
-
-    delete config;
-
-    capacity = 8;
-
-    uint32_t p2r = 1;
-    for (int i = depth; i >= 1; i--)
-    {
-        utils_p2r[i] = p2r;
-        p2r <<= 1;
-    }
-
-    data.resize(capacity);
-}
-
-void Octree::setProgram(GLuint program_){
-    program = program_;
-}
-
-void Octree::GenUBO(GLuint program_){
-    program = program_;
-    glGenBuffers(1, &gl_ID);
-    glBindBuffer(GL_TEXTURE_BUFFER, gl_ID);
-    glBufferData(GL_TEXTURE_BUFFER, capacity * 4, NULL, GL_DYNAMIC_DRAW);
-
-    // Generate and bind the texture object
-    glGenTextures(1, &texBufferID);
-    glBindTexture(GL_TEXTURE_BUFFER, texBufferID);
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, gl_ID);  // Assuming GL_R32UI as the internal format
-
-    // Unbind the buffer and texture
-    glBindBuffer(GL_TEXTURE_BUFFER, 0);
-    glBindTexture(GL_TEXTURE_BUFFER, 0);
-}
-
-void Octree::freeVRAM(){
-    glDeleteBuffers(1, &gl_ID);
-    glDeleteTextures(1, &texBufferID);
-}
-
-void Octree::BindUniforms(uint8_t &texturesBound){
-    glActiveTexture(GL_TEXTURE0 + texturesBound);
-    glBindTexture(GL_TEXTURE_BUFFER, texBufferID);
-
-    GLint texLoc = glGetUniformLocation(program, "octreeTexture");
-    GLint depthLoc = glGetUniformLocation(program, "octreeDepth");
-
-    glUniform1i(texLoc, (int)texturesBound);
-    glUniform1ui(depthLoc, (int)depth);
-    texturesBound++;
-}
-
-Octree::~Octree(){
-    freeVRAM();
-}
-
-void Octree::Update(){
-    glBindBuffer(GL_TEXTURE_BUFFER, gl_ID);
-    glBufferData(GL_TEXTURE_BUFFER, size * 4, data.data(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_TEXTURE_BUFFER, 0);
-}
-
-void Octree::UpdateNode(uint32_t index){
-    glBindBuffer(GL_TEXTURE_BUFFER, gl_ID);
-    glBufferSubData(GL_TEXTURE_BUFFER, index * 4, 4, &data[index].raw);
-    glBindBuffer(GL_TEXTURE_BUFFER, 0);
-}
-
-uint32_t  Octree::lookup(glm::uvec3 position){
-    uint32_t offset = 0;
-    for (int depth_ = 1; depth_ <= depth; depth_++)
-    {
-        offset += locate(position, depth_);
-        Node node = data[offset];
-        if (!node.base.isNode)
-            return offset;
-        offset = node.node.next;
-    }
-}
-
-void Octree::resizeDataIfNeeded(uint32_t requiredCapacity) {
-    if (requiredCapacity > capacity) {
-        // Double the capacity until it is larger than the required capacity
-        while (capacity < requiredCapacity) {
-            capacity *= 2;
-        }
-
-        Octree::Node newNode;
-        newNode.raw = 0;
-
-        data.resize(capacity, newNode);
-    
-        // Update UBO to reflect new capacity
-        glBindBuffer(GL_TEXTURE_BUFFER, gl_ID);
-        glBufferData(GL_TEXTURE_BUFFER, capacity * 4, data.data(), GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_TEXTURE_BUFFER, 0);
-    }
-}
-
-void Octree::insert(glm::uvec3 position, Node leaf){
-    if(position.x > (2 << depth) || position.y > (2 << depth) || position.z > (2 << depth))
-        return;
-    uint32_t offset = 0;
-    uint32_t lastNode = 0;
-    leaf.base.isNode=false;
-    for (int depth_ = 1; depth_ < depth; depth_++)
-    {
-        offset += locate(position, depth_);
-        Node node = data[offset];
-
-        if(!node.base.isNode){
-            uint32_t nextOffset;
-            if(freeNodes.empty()){
-                resizeDataIfNeeded(size+16);
-                nextOffset = size;
-                size+=8;
-            }else{
-                nextOffset = freeNodes.top();
-                freeNodes.pop();
-            }
-            Node node;
-            node.base.isNode = 1;
-            node.node.next = nextOffset;
-            node.node.count = 0;
-            data[offset] = node;
-            if(depth_>1)data[lastNode].node.count++;
-            UpdateNode(lastNode);
-            UpdateNode(offset);
-            lastNode = offset;
-            offset = nextOffset;
-        }else{
-            lastNode = offset;
-            offset = node.node.next;
-        }
-    }
-
-    int i = offset + locate(position, depth);
-    if(data[i].leaf.material == 0)data[lastNode].node.count++;
-    data[i] = leaf;
-    numVoxels++;
-    UpdateNode(lastNode);
-    UpdateNode(i);
-}
-
-void Octree::remove(glm::uvec3 position){
-
-}
-
-uint32_t Octree::locate(glm::uvec3 position, uint32_t depth_){
-    return (((bool)(position.x & utils_p2r[depth_])) << 2) | ((bool)((position.y & utils_p2r[depth_])) << 1) |((bool)(position.z & utils_p2r[depth_]));
-}
-
-bool Octree::contained(glm::uvec3 position1, glm::uvec3 position2, uint32_t depth_){
-     return ((position1.x >> depth_ == position2.x >> depth_) && (position1.y >> depth_ == position2.y >> depth_) && (position1.z >> depth_ == position2.z >> depth_));
-}
-
-uint32_t Octree::packedNormal(glm::vec3& normal){
-    // Convert normal vector components to 8-bit signed integers
-    glm::i8vec3 si = glm::i8vec3(
-        static_cast<int8_t>((normal.x + 1) * 127.0f),
-        static_cast<int8_t>((normal.y + 1) * 127.0f),
-        static_cast<int8_t>((normal.z + 1) * 127.0f)
-    );
-
-    // Pack the 8-bit integers into the 24-bit normal field
-    return ((uint32_t(si.x) & 0xFF) << 16) |
-            ((uint32_t(si.y) & 0xFF) << 8) |
-            (uint32_t(si.z) & 0xFF);
+#include "octree.hpp"
+#include "jobs.hpp"
+#include "iostream"
+#include <cmath>
+#include <cfloat>
+#include <mutex>
+#include <deque>
+
+Octree::Octree(Config *config){
+    depth = config->depth > maxDepth ? maxDepth : config->depth;
+
+    delete config;
+
+    capacity = 8;
+
+    uint32_t p2r = 1;
+    for (int i = depth; i >= 1; i--)
+    {
+        utils_p2r[i] = p2r;
+        p2r <<= 1;
+    }
+
+    data.resize(capacity);
+    attributes.resize(capacity, Attribute{0, 0, 0});
+    occlusion.resize(capacity, 255);
+}
+
+void Octree::setProgram(GLuint program_){
+    program = program_;
+}
+
+void Octree::GenUBO(GLuint program_){
+    program = program_;
+    resident = true;
+    glGenBuffers(1, &gl_ID);
+    glBindBuffer(GL_TEXTURE_BUFFER, gl_ID);
+    glBufferData(GL_TEXTURE_BUFFER, capacity * 4, NULL, GL_DYNAMIC_DRAW);
+
+    // Generate and bind the texture object
+    glGenTextures(1, &texBufferID);
+    glBindTexture(GL_TEXTURE_BUFFER, texBufferID);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, gl_ID);  // Assuming GL_R32UI as the internal format
+
+    glGenBuffers(1, &attributeBufferID);
+    glBindBuffer(GL_TEXTURE_BUFFER, attributeBufferID);
+    glBufferData(GL_TEXTURE_BUFFER, capacity * sizeof(Attribute), NULL, GL_DYNAMIC_DRAW);
+
+    glGenTextures(1, &attributeTexBufferID);
+    glBindTexture(GL_TEXTURE_BUFFER, attributeTexBufferID);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, attributeBufferID);
+
+    glGenBuffers(1, &occlusionBufferID);
+    glBindBuffer(GL_TEXTURE_BUFFER, occlusionBufferID);
+    glBufferData(GL_TEXTURE_BUFFER, capacity, occlusion.data(), GL_DYNAMIC_DRAW);
+
+    glGenTextures(1, &occlusionTexBufferID);
+    glBindTexture(GL_TEXTURE_BUFFER, occlusionTexBufferID);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R8, occlusionBufferID);
+
+    // Unbind the buffer and texture
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void Octree::freeVRAM(){
+    if(!resident)
+        return;
+    resident = false;
+    glDeleteBuffers(1, &gl_ID);
+    glDeleteTextures(1, &texBufferID);
+    glDeleteBuffers(1, &attributeBufferID);
+    glDeleteTextures(1, &attributeTexBufferID);
+    glDeleteBuffers(1, &occlusionBufferID);
+    glDeleteTextures(1, &occlusionTexBufferID);
+    if(ropeBufferID != 0){
+        glDeleteBuffers(1, &ropeBufferID);
+        glDeleteTextures(1, &ropeTexBufferID);
+        ropeBufferID = ropeTexBufferID = 0;
+    }
+}
+
+void Octree::BindUniforms(uint8_t &texturesBound, const core::PassUniforms &uniforms){
+    glActiveTexture(GL_TEXTURE0 + texturesBound);
+    glBindTexture(GL_TEXTURE_BUFFER, texBufferID);
+
+    glUniform1i(uniforms.location[core::OCTREE_TEXTURE], (int)texturesBound);
+    glUniform1ui(uniforms.location[core::OCTREE_DEPTH], (int)depth);
+    texturesBound++;
+
+    glActiveTexture(GL_TEXTURE0 + texturesBound);
+    glBindTexture(GL_TEXTURE_BUFFER, attributeTexBufferID);
+
+    glUniform1i(uniforms.location[core::ATTRIBUTE_TEXTURE], (int)texturesBound);
+    texturesBound++;
+
+    glActiveTexture(GL_TEXTURE0 + texturesBound);
+    glBindTexture(GL_TEXTURE_BUFFER, occlusionTexBufferID);
+
+    glUniform1i(uniforms.location[core::OCCLUSION_TEXTURE], (int)texturesBound);
+    texturesBound++;
+
+    glActiveTexture(GL_TEXTURE0 + texturesBound);
+    glBindTexture(GL_TEXTURE_BUFFER, ropeTexBufferID);
+
+    glUniform1i(uniforms.location[core::ROPE_TEXTURE], (int)texturesBound);
+    glUniform1i(uniforms.location[core::USE_ROPES], roped && ropeTexBufferID != 0);
+    texturesBound++;
+}
+
+Octree::~Octree(){
+    freeVRAM();
+}
+
+void Octree::Update(){
+    PROFILE_ZONE("Octree::Update");
+    modified = true;
+    revision++;
+    if(!resident)
+        return;
+    glBindBuffer(GL_TEXTURE_BUFFER, gl_ID);
+    glBufferData(GL_TEXTURE_BUFFER, size * 4, data.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, attributeBufferID);
+    glBufferData(GL_TEXTURE_BUFFER, size * sizeof(Attribute), attributes.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, occlusionBufferID);
+    glBufferData(GL_TEXTURE_BUFFER, size, occlusion.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    dirtyAttributesBegin = dirtyOcclusionBegin = dirtyDataBegin = UINT32_MAX;
+    dirtyAttributesEnd = dirtyOcclusionEnd = dirtyDataEnd = 0;
+    allocateRopes();
+}
+
+void Octree::UpdateNode(uint32_t index){
+    modified = true;
+    revision++;
+    if(!resident)
+        return;
+    glBindBuffer(GL_TEXTURE_BUFFER, gl_ID);
+    glBufferSubData(GL_TEXTURE_BUFFER, index * 4, 4, &data[index].raw);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+uint32_t  Octree::lookup(glm::uvec3 position){
+    uint32_t offset = 0;
+    for (int depth_ = 1; depth_ <= depth; depth_++)
+    {
+        offset += locate(position, depth_);
+        Node node = data[offset];
+        if (!node.base.isNode)
+            return offset;
+        offset = node.node.next;
+    }
+}
+
+void Octree::resizeDataIfNeeded(uint32_t requiredCapacity) {
+    if (requiredCapacity > capacity) {
+        PROFILE_ZONE("Octree::resize");
+        // Double the capacity until it is larger than the required capacity
+        while (capacity < requiredCapacity) {
+            capacity *= 2;
+        }
+
+        Octree::Node newNode;
+        newNode.raw = 0;
+
+        data.resize(capacity, newNode);
+        attributes.resize(capacity, Attribute{0, 0, 0});
+        occlusion.resize(capacity, 255);
+        if(roped)
+            ropes.resize((size_t)capacity * 6, NO_ROPE);
+        allocateVRAM();
+    }
+}
+
+//whole arrays at the current capacity, pending partial uploads are part of them
+void Octree::allocateVRAM(){
+    if(!resident)
+        return;
+
+    // Update UBO to reflect new capacity
+    glBindBuffer(GL_TEXTURE_BUFFER, gl_ID);
+    glBufferData(GL_TEXTURE_BUFFER, capacity * 4, data.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, attributeBufferID);
+    glBufferData(GL_TEXTURE_BUFFER, capacity * sizeof(Attribute), attributes.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, occlusionBufferID);
+    glBufferData(GL_TEXTURE_BUFFER, capacity, occlusion.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    dirtyAttributesBegin = dirtyOcclusionBegin = dirtyDataBegin = UINT32_MAX;
+    dirtyAttributesEnd = dirtyOcclusionEnd = dirtyDataEnd = 0;
+    allocateRopes();
+}
+
+void Octree::insert(glm::uvec3 position, Node leaf){
+    if(position.x >= (1u << depth) || position.y >= (1u << depth) || position.z >= (1u << depth))
+        return;
+    std::unique_lock<std::shared_mutex> lock(queryMutex);
+    uint32_t offset = 0;
+    uint32_t lastNode = 0;
+    uint32_t path[maxDepth];
+    uint32_t split = UINT32_MAX, splitDepth = 0;  //topmost leaf turned into a node
+    leaf.base.isNode=false;
+    for (int depth_ = 1; depth_ < depth; depth_++)
+    {
+        offset += locate(position, depth_);
+        path[depth_ - 1] = offset;
+        Node node = data[offset];
+
+        if(!node.base.isNode){
+            if(split == UINT32_MAX){
+                split = offset;
+                splitDepth = depth_;
+            }
+            uint32_t nextOffset;
+            if(freeNodes.empty()){
+                resizeDataIfNeeded(size+16);
+                nextOffset = size;
+                size+=8;
+            }else{
+                nextOffset = freeNodes.top();
+                freeNodes.pop();
+            }
+            Node node;
+            node.base.isNode = 1;
+            node.node.next = nextOffset;
+            node.node.count = 0;
+            data[offset] = node;
+            markSlot(offset, depth_, position);
+            if(depth_>1)data[lastNode].node.count++;
+            UpdateNode(lastNode);
+            UpdateNode(offset);
+            lastNode = offset;
+            offset = nextOffset;
+        }else{
+            lastNode = offset;
+            offset = node.node.next;
+        }
+    }
+
+    int i = offset + locate(position, depth);
+    if(data[i].leaf.material == 0)data[lastNode].node.count++;
+    data[i] = leaf;
+    markSlot(i, depth, position);
+    numVoxels++;
+    UpdateNode(lastNode);
+    UpdateNode(i);
+    updateAttributes(path, depth - 1);
+    markEdit(position);
+    if(roped && split != UINT32_MAX)
+        patchRopes(split, splitDepth, position & glm::uvec3(~(utils_p2r[splitDepth] - 1)));
+}
+
+void Octree::remove(glm::uvec3 position){
+    if(position.x >= (1u << depth) || position.y >= (1u << depth) || position.z >= (1u << depth))
+        return;
+    std::unique_lock<std::shared_mutex> lock(queryMutex);
+    uint32_t offset = 0;
+    uint32_t path[maxDepth];
+    for (int depth_ = 1; depth_ < depth; depth_++)
+    {
+        offset += locate(position, depth_);
+        path[depth_ - 1] = offset;
+        Node node = data[offset];
+        if(!node.base.isNode)
+            return;
+        offset = node.node.next;
+    }
+
+    int i = offset + locate(position, depth);
+    if(data[i].leaf.material == 0)
+        return;
+    data[i].raw = 0;
+    markSlot(i, depth, position);
+    numVoxels--;
+    UpdateNode(i);
+    markEdit(position);
+
+    int length = depth - 1;
+    uint32_t merged = UINT32_MAX, mergedDepth = 0;  //topmost node turned back into a leaf
+    if(length > 0){
+        data[path[length - 1]].node.count--;
+        UpdateNode(path[length - 1]);
+    }
+
+    // free child blocks left without any voxel, bottom up
+    while(length > 0){
+        uint32_t parent = path[length - 1];
+        uint32_t block = data[parent].node.next;
+        bool empty = true;
+        for(uint32_t c = 0; c < 8 && empty; c++)
+            empty = !data[block + c].base.isNode && data[block + c].leaf.material == 0;
+        if(!empty)
+            break;
+
+        for(uint32_t c = 0; c < 8; c++){
+            data[block + c].raw = 0;
+            attributes[block + c] = Attribute{0, 0, 0};
+        }
+        freeNodes.push(block);
+        data[parent].raw = 0;
+        attributes[parent] = Attribute{0, 0, 0};
+        markSlot(parent, length, position);
+        UpdateNode(parent);
+        merged = parent;
+        mergedDepth = length;
+        length--;
+        if(length > 0){
+            data[path[length - 1]].node.count--;
+            UpdateNode(path[length - 1]);
+        }
+    }
+    updateAttributes(path, length);
+    if(roped && merged != UINT32_MAX)
+        patchRopes(merged, mergedDepth, position & glm::uvec3(~(utils_p2r[mergedDepth] - 1)));
+}
+
+void Octree::updateAttributes(const uint32_t *path, int length){
+    // children first, every node is rebuilt from its 8 children
+    for(int k = length - 1; k >= 0; k--){
+        uint32_t index = path[k];
+        if(!data[index].base.isNode)
+            continue;
+
+        uint32_t block = data[index].node.next;
+        glm::vec3 normal(0.0f);
+        uint32_t coverage = 0, heaviest = 0, material = 0;
+        for(uint32_t c = 0; c < 8; c++){
+            Node child = data[block + c];
+            uint32_t weight;
+            uint32_t childNormal, childMaterial;
+            if(child.base.isNode){
+                weight = attributes[block + c].coverage;
+                childNormal = attributes[block + c].normal;
+                childMaterial = attributes[block + c].material;
+            }else{
+                weight = child.leaf.material == 0 ? 0 : 1;
+                childNormal = child.leaf.normal;
+                childMaterial = child.leaf.material;
+            }
+            if(weight == 0)
+                continue;
+            normal += unpackedNormal(childNormal) * (float)weight;
+            coverage += weight;
+            if(weight > heaviest){
+                heaviest = weight;
+                material = childMaterial;
+            }
+        }
+
+        if(glm::length(normal) > 0.0f)
+            normal = glm::normalize(normal);
+        attributes[index].normal = packedNormal(normal);
+        attributes[index].material = material;
+        attributes[index].coverage = coverage;
+
+        dirtyAttributesBegin = std::min(dirtyAttributesBegin, index);
+        dirtyAttributesEnd = std::max(dirtyAttributesEnd, index + 1);
+    }
+}
+
+void Octree::FlushAttributes(){
+    PROFILE_ZONE("Octree::FlushAttributes");
+    if(!resident)
+        return;
+    if(dirtyDataBegin < dirtyDataEnd){
+        glBindBuffer(GL_TEXTURE_BUFFER, gl_ID);
+        glBufferSubData(GL_TEXTURE_BUFFER, dirtyDataBegin * 4, (dirtyDataEnd - dirtyDataBegin) * 4, &data[dirtyDataBegin]);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        dirtyDataBegin = UINT32_MAX;
+        dirtyDataEnd = 0;
+        modified = true;
+    }
+    if(dirtyOcclusionBegin < dirtyOcclusionEnd){
+        glBindBuffer(GL_TEXTURE_BUFFER, occlusionBufferID);
+        glBufferSubData(GL_TEXTURE_BUFFER, dirtyOcclusionBegin, dirtyOcclusionEnd - dirtyOcclusionBegin, &occlusion[dirtyOcclusionBegin]);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        dirtyOcclusionBegin = UINT32_MAX;
+        dirtyOcclusionEnd = 0;
+        modified = true;
+    }
+    if(dirtyRopesBegin < dirtyRopesEnd && ropeBufferID != 0){
+        glBindBuffer(GL_TEXTURE_BUFFER, ropeBufferID);
+        glBufferSubData(GL_TEXTURE_BUFFER, dirtyRopesBegin * 24, (dirtyRopesEnd - dirtyRopesBegin) * 24, &ropes[dirtyRopesBegin * 6]);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        dirtyRopesBegin = UINT32_MAX;
+        dirtyRopesEnd = 0;
+    }
+
+    if(dirtyAttributesBegin >= dirtyAttributesEnd)
+        return;
+    glBindBuffer(GL_TEXTURE_BUFFER, attributeBufferID);
+    glBufferSubData(GL_TEXTURE_BUFFER, dirtyAttributesBegin * sizeof(Attribute), (dirtyAttributesEnd - dirtyAttributesBegin) * sizeof(Attribute), &attributes[dirtyAttributesBegin]);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    dirtyAttributesBegin = UINT32_MAX;
+    dirtyAttributesEnd = 0;
+    modified = true;
+}
+
+void Octree::setRopes(bool enabled){
+    PROFILE_ZONE("Octree::setRopes");
+    {
+        std::unique_lock<std::shared_mutex> lock(queryMutex);
+        roped = enabled;
+        if(enabled){
+            ropes.assign((size_t)capacity * 6, NO_ROPE);
+            ropeSubtree(UINT32_MAX, 0);
+        }else{
+            std::vector<uint32_t>().swap(ropes);
+        }
+    }
+    allocateRopes();
+    modified = true;
+}
+
+//rope texture buffer at the current capacity, created on first use and deleted once ropes are dropped
+void Octree::allocateRopes(){
+    if(!resident)
+        return;
+    if(!roped){
+        if(ropeBufferID != 0){
+            glDeleteBuffers(1, &ropeBufferID);
+            glDeleteTextures(1, &ropeTexBufferID);
+            ropeBufferID = ropeTexBufferID = 0;
+        }
+        return;
+    }
+
+    if(ropeBufferID == 0){
+        glGenBuffers(1, &ropeBufferID);
+        glGenTextures(1, &ropeTexBufferID);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, ropeBufferID);
+    glBufferData(GL_TEXTURE_BUFFER, (size_t)capacity * 24, ropes.data(), GL_DYNAMIC_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, ropeTexBufferID);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, ropeBufferID);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    dirtyRopesBegin = UINT32_MAX;
+    dirtyRopesEnd = 0;
+}
+
+//deepest slot of at most depth_ holding position, as a rope
+uint32_t Octree::ropeTo(glm::uvec3 position, uint32_t depth_) const{
+    uint32_t extent = utils_p2r[1] << 1;
+    if(position.x >= extent || position.y >= extent || position.z >= extent)
+        return NO_ROPE;
+    uint32_t offset = 0;
+    for(uint32_t d = 1; ; d++){
+        offset += locate(position, d);
+        if(d == depth_ || !data[offset].base.isNode)
+            return (offset << 4) | (d - 1);
+        offset = data[offset].node.next;
+    }
+}
+
+//ropes of every slot below slot (UINT32_MAX for the root block) from the ropes of their parents, top down:
+//inner faces link to the sibling, outer faces to the parent's neighbour or, if it is split, its child across the face
+void Octree::ropeSubtree(uint32_t slot, uint32_t depth_){
+    std::vector<std::pair<uint32_t, uint32_t>> stack = {{slot, depth_}};
+    while(!stack.empty()){
+        auto [parent, parentDepth] = stack.back();
+        stack.pop_back();
+        uint32_t block = parent == UINT32_MAX ? 0 : (uint32_t)data[parent].node.next;
+        for(uint32_t c = 0; c < 8; c++){
+            uint32_t child = block + c;
+            for(uint32_t f = 0; f < 6; f++){
+                uint32_t bit = 4 >> (f / 2);
+                bool positive = f & 1;
+                uint32_t rope;
+                if(((c & bit) != 0) != positive){
+                    rope = ((block + (c ^ bit)) << 4) | parentDepth;
+                }else{
+                    uint32_t outer = parent == UINT32_MAX ? NO_ROPE : ropes[parent * 6 + f];
+                    uint32_t target = outer >> 4;
+                    if(outer != NO_ROPE && (outer & 15) + 1 == parentDepth && data[target].base.isNode)
+                        rope = ((data[target].node.next + (c ^ bit)) << 4) | parentDepth;
+                    else
+                        rope = outer;
+                }
+                ropes[child * 6 + f] = rope;
+            }
+            if(data[child].base.isNode)
+                stack.push_back({child, parentDepth + 1});
+        }
+        dirtyRopesBegin = std::min(dirtyRopesBegin, block);
+        dirtyRopesEnd = std::max(dirtyRopesEnd, block + 8);
+    }
+}
+
+//after slot was split or merged: its subtree is refilled, and the slots at least as deep touching it from outside
+//are linked again by descent, the only ones that could point into it
+void Octree::patchRopes(uint32_t slot, uint32_t depth_, glm::uvec3 position){
+    PROFILE_ZONE("Octree::patchRopes");
+    if(data[slot].base.isNode)
+        ropeSubtree(slot, depth_);
+
+    glm::ivec3 min = glm::ivec3(position) - 1, max = glm::ivec3(position) + (int)utils_p2r[depth_];
+    struct Entry{
+        uint32_t block, depth_;
+        glm::uvec3 origin;
+    };
+    std::vector<Entry> stack = {{0, 1, glm::uvec3(0)}};
+    while(!stack.empty()){
+        Entry entry = stack.back();
+        stack.pop_back();
+        uint32_t size = utils_p2r[entry.depth_];
+        for(uint32_t c = 0; c < 8; c++){
+            uint32_t child = entry.block + c;
+            glm::uvec3 origin = entry.origin + glm::uvec3((c >> 2) & 1, (c >> 1) & 1, c & 1) * size;
+            glm::ivec3 lo = glm::ivec3(origin), hi = lo + (int)size - 1;
+            if(child == slot || hi.x < min.x || hi.y < min.y || hi.z < min.z || lo.x > max.x || lo.y > max.y || lo.z > max.z)
+                continue;
+
+            if(entry.depth_ >= depth_){
+                for(uint32_t f = 0; f < 6; f++){
+                    glm::uvec3 across = origin;
+                    across[f / 2] += (f & 1) ? size : UINT32_MAX;
+                    ropes[child * 6 + f] = ropeTo(across, entry.depth_);
+                }
+                dirtyRopesBegin = std::min(dirtyRopesBegin, child);
+                dirtyRopesEnd = std::max(dirtyRopesEnd, child + 1);
+            }
+            if(data[child].base.isNode)
+                stack.push_back({data[child].node.next, entry.depth_ + 1, origin});
+        }
+    }
+}
+
+void Octree::setOcclusion(uint32_t index, uint8_t value){
+    if(occlusion[index] == value)
+        return;
+    occlusion[index] = value;
+    dirtyOcclusionBegin = std::min(dirtyOcclusionBegin, index);
+    dirtyOcclusionEnd = std::max(dirtyOcclusionEnd, index + 1);
+}
+
+#define MAX_DIRTY_REGIONS 32
+
+void Octree::markEdit(glm::uvec3 position){
+    markShading(position);
+
+    //a position next to a region grows it, past the cap it goes to the region growing the least
+    size_t best = dirtyRegions.size();
+    uint64_t bestGrowth = UINT64_MAX;
+    for(size_t i = 0; i < dirtyRegions.size(); i++){
+        Region &region = dirtyRegions[i];
+        glm::uvec3 min = glm::min(region.min, position), max = glm::max(region.max, position);
+        glm::uvec3 extent = region.max - region.min + glm::uvec3(1), grown = max - min + glm::uvec3(1);
+        if(grown.x <= extent.x + 1 && grown.y <= extent.y + 1 && grown.z <= extent.z + 1){
+            best = i;
+            break;
+        }
+        if(dirtyRegions.size() < MAX_DIRTY_REGIONS)
+            continue;
+        uint64_t growth = (uint64_t)grown.x * grown.y * grown.z - (uint64_t)extent.x * extent.y * extent.z;
+        if(growth < bestGrowth){
+            bestGrowth = growth;
+            best = i;
+        }
+    }
+    if(best == dirtyRegions.size()){
+        dirtyRegions.push_back({position, position});
+        return;
+    }
+    dirtyRegions[best].min = glm::min(dirtyRegions[best].min, position);
+    dirtyRegions[best].max = glm::max(dirtyRegions[best].max, position);
+}
+
+void Octree::markShading(glm::uvec3 position){
+    if(!edited){
+        editMin = editMax = position;
+        edited = true;
+        return;
+    }
+    editMin = glm::min(editMin, position);
+    editMax = glm::max(editMax, position);
+}
+
+//only the GPU volume keeps the log, it is drained every frame
+void Octree::markSlot(uint32_t index, uint32_t depth_, glm::uvec3 position){
+    if(resident)
+        slotEdits.push_back({index, depth_, position & glm::uvec3(~(utils_p2r[depth_] - 1))});
+}
+
+bool Octree::consumeSlotEdits(std::vector<SlotEdit> &edits){
+    edits.swap(slotEdits);
+    slotEdits.clear();
+    return !edits.empty();
+}
+
+bool Octree::consumeDirtyRegions(std::vector<Region> &regions){
+    regions.swap(dirtyRegions);
+    dirtyRegions.clear();
+    return !regions.empty();
+}
+
+//only the normal bits change, node counts and child links stay as they are
+uint32_t Octree::setNormals(const std::vector<std::pair<glm::uvec3, uint32_t>> &normals){
+    std::unique_lock<std::shared_mutex> lock(queryMutex);
+    uint32_t changed = 0;
+    for(const std::pair<glm::uvec3, uint32_t> &normal : normals){
+        uint32_t offset = 0;
+        uint32_t path[maxDepth];
+        bool found = true;
+        for(int depth_ = 1; depth_ < depth && found; depth_++){
+            offset += locate(normal.first, depth_);
+            path[depth_ - 1] = offset;
+            found = data[offset].base.isNode;
+            offset = data[offset].node.next;
+        }
+        if(!found)
+            continue;
+
+        uint32_t i = offset + locate(normal.first, depth);
+        if(data[i].base.isNode || data[i].leaf.material == 0 || data[i].leaf.normal == normal.second)
+            continue;
+        data[i].leaf.normal = normal.second;
+        dirtyDataBegin = std::min(dirtyDataBegin, i);
+        dirtyDataEnd = std::max(dirtyDataEnd, i + 1);
+        updateAttributes(path, depth - 1);
+        markShading(normal.first);
+        changed++;
+    }
+    if(changed > 0)
+        revision++;
+    return changed;
+}
+
+bool Octree::consumeEdits(glm::uvec3 &min, glm::uvec3 &max){
+    if(!edited)
+        return false;
+    min = editMin;
+    max = editMax;
+    edited = false;
+    return true;
+}
+
+void Octree::hierarchy(std::vector<std::vector<uint32_t>> &nodes, std::vector<glm::uvec4> &leaves){
+    PROFILE_ZONE("Octree::hierarchy");
+    nodes.assign(depth > 1 ? depth - 1 : 0, std::vector<uint32_t>());
+    leaves.clear();
+
+    struct Entry{ uint32_t block; int depth_; glm::uvec3 position; };
+    std::stack<Entry> stack;
+    stack.push({0, 1, glm::uvec3(0)});
+    while(!stack.empty()){
+        Entry entry = stack.top();
+        stack.pop();
+        for(uint32_t c = 0; c < 8; c++){
+            uint32_t index = entry.block + c;
+            glm::uvec3 position = entry.position | (glm::uvec3((c >> 2) & 1, (c >> 1) & 1, c & 1) * utils_p2r[entry.depth_]);
+            Node node = data[index];
+            if(entry.depth_ < depth && node.base.isNode){
+                nodes[entry.depth_ - 1].push_back(index);
+                stack.push({node.node.next, entry.depth_ + 1, position});
+            }else if(!node.base.isNode && node.leaf.material != 0){
+                leaves.push_back(glm::uvec4(index, position.x, position.y, position.z));
+            }
+        }
+    }
+}
+
+Octree::Region Octree::everything() const{
+    return {glm::uvec3(0), glm::uvec3((1u << depth) - 1)};
+}
+
+//children of block touching region, empty subtrees are skipped through their coverage
+void Octree::visitNode(uint32_t block, uint32_t depth_, glm::uvec3 origin, const Region &region, const LeafVisitor &visit) const{
+    uint32_t size = utils_p2r[depth_];
+    for(uint32_t i = 0; i < 8; i++){
+        glm::uvec3 childMin = origin | glm::uvec3((i >> 2) & 1, (i >> 1) & 1, i & 1) * size;
+        glm::uvec3 childMax = childMin + glm::uvec3(size - 1);
+        if(region.min.x > childMax.x || region.min.y > childMax.y || region.min.z > childMax.z || region.max.x < childMin.x || region.max.y < childMin.y || region.max.z < childMin.z)
+            continue;
+
+        Node node = data[block + i];
+        if(node.base.isNode && depth_ < depth){
+            if(attributes[block + i].coverage > 0)
+                visitNode(node.node.next, depth_ + 1, childMin, region, visit);
+        }else if(!node.base.isNode && node.leaf.material != 0){
+            visit({block + i, childMin, size, node.leaf});
+        }
+    }
+}
+
+void Octree::forEachLeaf(const LeafVisitor &visit) const{
+    forEachLeaf(everything(), visit);
+}
+
+void Octree::forEachLeaf(const Region &region, const LeafVisitor &visit) const{
+    std::shared_lock<std::shared_mutex> lock(queryMutex);
+    visitNode(0, 1, glm::uvec3(0), region, visit);
+}
+
+void Octree::forEachLeafParallel(JobSystem *jobs, const LeafVisitor &visit, uint32_t grain) const{
+    forEachLeafParallel(jobs, everything(), visit, grain);
+}
+
+//splits top down while a subtree's coverage is above grain, leaves met on the way are visited here
+void Octree::forEachLeafParallel(JobSystem *jobs, const Region &region, const LeafVisitor &visit, uint32_t grain) const{
+    PROFILE_ZONE("Octree::forEachLeafParallel");
+    std::shared_lock<std::shared_mutex> lock(queryMutex);
+    struct Subtree{ uint32_t block; uint32_t depth_; glm::uvec3 origin; };
+    std::vector<Subtree> subtrees, open = {{0, 1, glm::uvec3(0)}};
+    while(!open.empty()){
+        Subtree subtree = open.back();
+        open.pop_back();
+        uint32_t size = utils_p2r[subtree.depth_];
+        for(uint32_t i = 0; i < 8; i++){
+            uint32_t index = subtree.block + i;
+            glm::uvec3 childMin = subtree.origin | glm::uvec3((i >> 2) & 1, (i >> 1) & 1, i & 1) * size;
+            glm::uvec3 childMax = childMin + glm::uvec3(size - 1);
+            if(region.min.x > childMax.x || region.min.y > childMax.y || region.min.z > childMax.z || region.max.x < childMin.x || region.max.y < childMin.y || region.max.z < childMin.z)
+                continue;
+
+            Node node = data[index];
+            if(node.base.isNode && subtree.depth_ < depth){
+                if(attributes[index].coverage == 0)
+                    continue;
+                Subtree child = {node.node.next, subtree.depth_ + 1, childMin};
+                if(attributes[index].coverage > grain && child.depth_ < depth)
+                    open.push_back(child);
+                else
+                    subtrees.push_back(child);
+            }else if(!node.base.isNode && node.leaf.material != 0){
+                visit({index, childMin, size, node.leaf});
+            }
+        }
+    }
+
+    //the lock is held by this thread for the workers, edits wait until every subtree is done
+    jobs->parallelFor(subtrees.size(), 1, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++)
+            visitNode(subtrees[i].block, subtrees[i].depth_, subtrees[i].origin, region, visit);
+    });
+}
+
+std::shared_ptr<Octree::Compaction> Octree::compact(Order order) const{
+    PROFILE_ZONE("Octree::compact");
+    std::shared_lock<std::shared_mutex> lock(queryMutex);
+    std::shared_ptr<Compaction> compaction = std::make_shared<Compaction>();
+    compaction->revision = revision;
+    compaction->order = order;
+
+    //old block to place, new block it goes to, depth of its slots
+    struct Move{ uint32_t from; uint32_t to; uint32_t depth_; };
+    std::deque<Move> moves = {{0, 0, 1}};
+    std::vector<Move> layout;
+    while(!moves.empty()){
+        Move move;
+        if(order == BREADTH_FIRST){
+            move = moves.front();
+            moves.pop_front();
+        }else{
+            move = moves.back();
+            moves.pop_back();
+        }
+        move.to = (uint32_t)layout.size() * 8;
+        layout.push_back(move);
+
+        //a block's place is the order it leaves the queue (or stack) in
+        std::vector<Move> children;
+        for(uint32_t c = 0; c < 8; c++){
+            Node node = data[move.from + c];
+            if(node.base.isNode && move.depth_ < depth)
+                children.push_back({(uint32_t)node.node.next, 0, move.depth_ + 1});
+        }
+        if(order == DEPTH_FIRST){
+            //the first child's subtree comes right after this block, then the second one's...
+            for(auto child = children.rbegin(); child != children.rend(); child++)
+                moves.push_back(*child);
+        }else{
+            for(Move &child : children)
+                moves.push_back(child);
+        }
+    }
+
+    //blocks land in the order they were taken, blocks start at multiples of 8 so links are remapped per block
+    std::vector<uint32_t> placedAt(size / 8 + 1, 0);
+    for(const Move &move : layout)
+        placedAt[move.from / 8] = move.to;
+    uint32_t placed = (uint32_t)layout.size() * 8;
+
+    compaction->size = placed;
+    compaction->capacity = 8;
+    while(compaction->capacity < placed)
+        compaction->capacity *= 2;
+    Node empty;
+    empty.raw = 0;
+    compaction->data.assign(compaction->capacity, empty);
+    compaction->attributes.assign(compaction->capacity, Attribute{0, 0, 0});
+    compaction->source.assign(placed, 0);
+    for(const Move &move : layout){
+        for(uint32_t c = 0; c < 8; c++){
+            uint32_t from = move.from + c, to = move.to + c;
+            Node node = data[from];
+            if(node.base.isNode && move.depth_ < depth)
+                node.node.next = placedAt[node.node.next / 8];
+            compaction->data[to] = node;
+            compaction->attributes[to] = attributes[from];
+            compaction->source[to] = from;
+        }
+    }
+    return compaction;
+}
+
+bool Octree::install(Compaction &compaction){
+    PROFILE_ZONE("Octree::install");
+    {
+        std::unique_lock<std::shared_mutex> lock(queryMutex);
+        if(compaction.revision != revision)
+            return false;
+
+        //occlusion is baked without the lock, so it is only read here
+        std::vector<uint8_t> gathered(compaction.capacity, 255);
+        for(uint32_t i = 0; i < compaction.size; i++)
+            gathered[i] = occlusion[compaction.source[i]];
+
+        data.swap(compaction.data);
+        attributes.swap(compaction.attributes);
+        occlusion.swap(gathered);
+        size = compaction.size;
+        capacity = compaction.capacity;
+        freeNodes = std::stack<uint32_t>();
+        slotEdits.clear();
+        if(roped){
+            ropes.assign((size_t)capacity * 6, NO_ROPE);
+            ropeSubtree(UINT32_MAX, 0);
+        }
+    }
+
+    //every node index changed, whatever is keyed by them has to notice
+    allocateVRAM();
+    modified = true;
+    revision++;
+    layoutRevision++;
+    return true;
+}
+
+core::OctreeStats Octree::computeStats(JobSystem *jobs) const{
+    PROFILE_ZONE("Octree::computeStats");
+    double start = glfwGetTime();
+    core::OctreeStats stats;
+    stats.nodes.assign(depth, 0);
+    stats.leaves.assign(depth, 0);
+    stats.fill.assign(depth, 0.0f);
+
+    //one row of counts per worker, summed once the visitor is done
+    std::vector<std::vector<uint32_t>> leaves(jobs->threads + 1, std::vector<uint32_t>(depth, 0));
+    forEachLeafParallel(jobs, [&](const Leaf &leaf){
+        uint32_t level = depth - 1;
+        for(uint32_t s = leaf.size; s > 1; s >>= 1)
+            level--;
+        leaves[jobs->worker()][level]++;
+    });
+    for(const std::vector<uint32_t> &row : leaves)
+        for(uint32_t level = 0; level < depth; level++)
+            stats.leaves[level] += row[level];
+
+    //internal nodes only, the blocks of the bottom depth are never read
+    std::shared_lock<std::shared_mutex> lock(queryMutex);
+    std::vector<std::pair<uint32_t, uint32_t>> open = {{0, 1}};
+    while(!open.empty()){
+        std::pair<uint32_t, uint32_t> block = open.back();
+        open.pop_back();
+        for(uint32_t c = 0; c < 8; c++){
+            Node node = data[block.first + c];
+            if(!node.base.isNode || block.second >= depth)
+                continue;
+            stats.nodes[block.second - 1]++;
+            if(block.second + 1 < depth)
+                open.push_back({(uint32_t)node.node.next, block.second + 1});
+        }
+    }
+
+    //the root block plus one block per internal node
+    stats.reachable = 8;
+    for(uint32_t level = 0; level < depth; level++){
+        uint32_t blocks = level == 0 ? 1 : stats.nodes[level - 1];
+        stats.reachable += 8 * stats.nodes[level];
+        if(blocks > 0)
+            stats.fill[level] = (float)(stats.nodes[level] + stats.leaves[level]) / (float)(8 * blocks);
+    }
+    stats.slots = size;
+    stats.capacity = capacity;
+    stats.freeBlocks = freeNodes.size();
+    stats.fragmentation = size == 0 ? 0.0f : 1.0f - (float)std::min(stats.reachable, size) / (float)size;
+    stats.revision = revision;
+    stats.ms = (glfwGetTime() - start) * 1000.0;
+    return stats;
+}
+
+std::string core::OctreeStats::json() const{
+    std::ostringstream out;
+    auto list = [&out](const char *name, const auto &values){
+        out << "  \"" << name << "\": [";
+        for(size_t i = 0; i < values.size(); i++)
+            out << (i > 0 ? ", " : "") << values[i];
+        out << "],\n";
+    };
+    out << "{\n";
+    list("nodes", nodes);
+    list("leaves", leaves);
+    list("fill", fill);
+    out << "  \"slots\": " << slots << ",\n";
+    out << "  \"capacity\": " << capacity << ",\n";
+    out << "  \"reachable\": " << reachable << ",\n";
+    out << "  \"free_blocks\": " << freeBlocks << ",\n";
+    out << "  \"fragmentation\": " << fragmentation << ",\n";
+    out << "  \"revision\": " << revision << ",\n";
+    out << "  \"ms\": " << ms << "\n";
+    out << "}\n";
+    return out.str();
+}
+
+//zero components get a huge finite inverse so the slab products never turn into 0 * inf
+glm::vec3 Octree::inverseDirection(const glm::vec3 &direction){
+    glm::vec3 inverse;
+    for(int a = 0; a < 3; a++)
+        inverse[a] = direction[a] == 0.0f ? FLT_MAX : 1.0f / direction[a];
+    return inverse;
+}
+
+//cell holding position, found by walking down until the first node without children
+bool Octree::descend(glm::uvec3 position, uint32_t &index, uint32_t &size) const{
+    uint32_t offset = 0;
+    for(uint32_t depth_ = 1; depth_ <= depth; depth_++){
+        offset += locate(position, depth_);
+        Node node = data[offset];
+        if(!node.base.isNode || depth_ == depth){
+            index = offset;
+            size = utils_p2r[depth_];
+            return !node.base.isNode && node.leaf.material != 0;
+        }
+        offset = node.node.next;
+    }
+    return false;
+}
+
+//steps cell to cell from tEnter, every empty cell is skipped whole at the size of the node that holds it
+Octree::RayHit Octree::traverse(const Ray &ray, const glm::vec3 &inverse, float tEnter, float tExit) const{
+    RayHit result = {false, 0.0f, glm::uvec3(0), 0, glm::vec3(0.0f)};
+    if(tEnter > tExit)
+        return result;
+
+    int length = 1 << depth;
+    glm::ivec3 cell = glm::clamp(glm::ivec3(glm::floor(ray.origin + ray.direction * tEnter)), glm::ivec3(0), glm::ivec3(length - 1));
+
+    //every step crosses at least one cell boundary along the exit axis
+    for(uint32_t step = 0; step < (3u << depth); step++){
+        uint32_t index, size;
+        bool solid = descend(glm::uvec3(cell), index, size);
+
+        glm::vec3 cellMin = glm::vec3(glm::uvec3(cell) & ~glm::uvec3(size - 1));
+        glm::vec3 cellMax = cellMin + glm::vec3((float)size);
+        glm::vec3 t1 = (cellMin - ray.origin) * inverse, t2 = (cellMax - ray.origin) * inverse;
+        glm::vec3 tmin = glm::min(t1, t2), tmax = glm::max(t1, t2);
+        float enter = std::max(std::max(tmin.x, tmin.y), tmin.z);
+        float leave = std::min(std::min(tmax.x, tmax.y), tmax.z);
+
+        if(solid){
+            result.distance = std::max(enter, tEnter);
+            if(result.distance > tExit)
+                return result;
+            result.hit = true;
+            result.position = glm::uvec3(cell);
+            result.index = index;
+            if(enter <= 0.0f){
+                result.normal = -glm::normalize(ray.direction);
+            }else{
+                int axis = tmin.x > tmin.y ? (tmin.x > tmin.z ? 0 : 2) : (tmin.y > tmin.z ? 1 : 2);
+                result.normal[axis] = ray.direction[axis] > 0.0f ? -1.0f : 1.0f;
+            }
+            return result;
+        }
+
+        if(leave >= tExit)
+            break;
+
+        int axis = tmax.x < tmax.y ? (tmax.x < tmax.z ? 0 : 2) : (tmax.y < tmax.z ? 1 : 2);
+        cell = glm::ivec3(glm::floor(ray.origin + ray.direction * leave));
+        cell[axis] = ray.direction[axis] > 0.0f ? (int)cellMax[axis] : (int)cellMin[axis] - 1;
+        if(cell[axis] < 0 || cell[axis] >= length)
+            break;
+        cell = glm::clamp(cell, glm::ivec3(0), glm::ivec3(length - 1));
+    }
+    return result;
+}
+
+Octree::RayHit Octree::raycast(const Ray &ray) const{
+    std::shared_lock<std::shared_mutex> lock(queryMutex);
+    glm::vec3 inverse = inverseDirection(ray.direction);
+    glm::vec3 t1 = -ray.origin * inverse, t2 = (glm::vec3((float)(1u << depth)) - ray.origin) * inverse;
+    glm::vec3 tmin = glm::min(t1, t2), tmax = glm::max(t1, t2);
+    float enter = std::max(std::max(std::max(tmin.x, tmin.y), tmin.z), 0.0f);
+    float leave = std::min(std::min(std::min(tmax.x, tmax.y), tmax.z), ray.maxDistance);
+    return traverse(ray, inverse, enter, leave);
+}
+
+void Octree::raycastBatch(JobSystem *jobs, const Ray *rays, RayHit *hits, size_t count) const{
+    std::shared_lock<std::shared_mutex> lock(queryMutex);
+
+    //clips the whole batch against the volume first, a branch free loop over plain arrays the compiler vectorizes,
+    //so rays that miss the volume never reach the traversal
+    std::vector<float> enter(count), leave(count);
+    std::vector<glm::vec3> inverse(count);
+    float length = (float)(1u << depth);
+    for(size_t i = 0; i < count; i++){
+        inverse[i] = inverseDirection(rays[i].direction);
+        glm::vec3 t1 = -rays[i].origin * inverse[i], t2 = (glm::vec3(length) - rays[i].origin) * inverse[i];
+        glm::vec3 tmin = glm::min(t1, t2), tmax = glm::max(t1, t2);
+        enter[i] = std::max(std::max(std::max(tmin.x, tmin.y), tmin.z), 0.0f);
+        leave[i] = std::min(std::min(std::min(tmax.x, tmax.y), tmax.z), rays[i].maxDistance);
+    }
+
+    //fixed chunks on the shared workers, so rays that walk long empty stretches don't stall one thread
+    jobs->parallelFor(count, 256, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++)
+            hits[i] = traverse(rays[i], inverse[i], enter[i], leave[i]);
+    });
+}
+
+bool Octree::overlapNode(uint32_t block, uint32_t depth_, glm::uvec3 origin, const glm::vec3 &min, const glm::vec3 &max, std::vector<glm::uvec3> *voxels) const{
+    bool found = false;
+    uint32_t size = utils_p2r[depth_];
+    for(uint32_t i = 0; i < 8; i++){
+        glm::uvec3 childMin = origin | glm::uvec3((i >> 2) & 1, (i >> 1) & 1, i & 1) * size;
+        glm::vec3 lo = glm::vec3(childMin), hi = lo + glm::vec3((float)size);
+        if(min.x >= hi.x || min.y >= hi.y || min.z >= hi.z || max.x <= lo.x || max.y <= lo.y || max.z <= lo.z)
+            continue;
+
+        Node node = data[block + i];
+        if(node.base.isNode && depth_ < depth){
+            found |= overlapNode(node.node.next, depth_ + 1, childMin, min, max, voxels);
+        }else if(!node.base.isNode && node.leaf.material != 0){
+            found = true;
+            if(voxels)
+                voxels->push_back(childMin);
+        }
+        if(found && !voxels)
+            return true;
+    }
+    return found;
+}
+
+bool Octree::overlapAABB(glm::vec3 min, glm::vec3 max, std::vector<glm::uvec3> *voxels) const{
+    std::shared_lock<std::shared_mutex> lock(queryMutex);
+    return overlapNode(0, 1, glm::uvec3(0), min, max, voxels);
+}
+
+//the leaves around the swept volume are tested exactly as the box center against each leaf grown by the half extent
+Octree::RayHit Octree::sweepAABB(glm::vec3 min, glm::vec3 max, glm::vec3 direction, float maxDistance) const{
+    std::shared_lock<std::shared_mutex> lock(queryMutex);
+    RayHit result = {false, maxDistance, glm::uvec3(0), 0, glm::vec3(0.0f)};
+
+    glm::vec3 offset = direction * maxDistance;
+    std::vector<glm::uvec3> candidates;
+    if(!overlapNode(0, 1, glm::uvec3(0), glm::min(min, min + offset), glm::max(max, max + offset), &candidates))
+        return result;
+
+    glm::vec3 half = (max - min) * 0.5f, center = (min + max) * 0.5f;
+    glm::vec3 inverse = inverseDirection(direction);
+    for(const glm::uvec3 &voxel : candidates){
+        glm::vec3 lo = glm::vec3(voxel) - half, hi = glm::vec3(voxel) + glm::vec3(1.0f) + half;
+        glm::vec3 t1 = (lo - center) * inverse, t2 = (hi - center) * inverse;
+        glm::vec3 tmin = glm::min(t1, t2), tmax = glm::max(t1, t2);
+        float enter = std::max(std::max(tmin.x, tmin.y), tmin.z);
+        float leave = std::min(std::min(tmax.x, tmax.y), tmax.z);
+        if(enter > leave || leave <= 0.0f || std::max(enter, 0.0f) > result.distance)
+            continue;
+
+        result.hit = true;
+        result.distance = std::max(enter, 0.0f);
+        result.position = voxel;
+        uint32_t size;
+        descend(voxel, result.index, size);
+        result.normal = glm::vec3(0.0f);
+        if(enter <= 0.0f){
+            result.normal = -glm::normalize(direction);
+        }else{
+            int axis = tmin.x > tmin.y ? (tmin.x > tmin.z ? 0 : 2) : (tmin.y > tmin.z ? 1 : 2);
+            result.normal[axis] = direction[axis] > 0.0f ? -1.0f : 1.0f;
+        }
+    }
+    return result;
+}
+
+uint32_t Octree::locate(glm::uvec3 position, uint32_t depth_) const{
+    return (((bool)(position.x & utils_p2r[depth_])) << 2) | ((bool)((position.y & utils_p2r[depth_])) << 1) |((bool)(position.z & utils_p2r[depth_]));
+}
+
+bool Octree::contained(glm::uvec3 position1, glm::uvec3 position2, uint32_t depth_){
+     return ((position1.x >> depth_ == position2.x >> depth_) && (position1.y >> depth_ == position2.y >> depth_) && (position1.z >> depth_ == position2.z >> depth_));
+}
+
+//inverse of packedNormal, decoded the same way as UnpackNormal in the ray shaders
+glm::vec3 Octree::unpackedNormal(uint32_t packedNormal){
+    glm::vec2 e = glm::vec2((float)((packedNormal >> 8) & 0xFF), (float)(packedNormal & 0xFF)) * (2.0f / 255.0f) - glm::vec2(1.0f);
+    glm::vec3 n = glm::vec3(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    if(n.z < 0.0f){
+        float x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+        float y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+        n.x = x;
+        n.y = y;
+    }
+    return glm::normalize(n);
+}
+
+uint32_t Octree::packedNormal(glm::vec3& normal){
+    // Project onto the octahedron |x|+|y|+|z| = 1 and fold the lower half over the diagonals
+    float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if(l1 == 0.0f)
+        return (128 << 8) | 128;
+    glm::vec3 n = normal / l1;
+    glm::vec2 e = glm::vec2(n.x, n.y);
+    if(n.z < 0.0f){
+        e.x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+        e.y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+
+    // Pack both coordinates as 8-bit unorm into the 16-bit normal field
+    uint32_t x = (uint32_t)std::round(glm::clamp(e.x * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f);
+    uint32_t y = (uint32_t)std::round(glm::clamp(e.y * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f);
+    return (x << 8) | y;
 }
\ No newline at end of file
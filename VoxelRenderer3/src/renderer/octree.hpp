@@ -1,77 +1,235 @@
-#pragma once
-
-#include "core.hpp"
-
-#include <stack>
-#include <functional>
-#include <cstdlib>
-
-#define maxDepth 16
-
-class Renderer;
-class Octree{
-    public:
-        struct NodeBase {
-            unsigned isNode : 1;
-        };
-
-        struct NodeData {
-            unsigned isNode : 1;
-            unsigned count : 3;
-            unsigned next : 28;
-        };
-
-        struct LeafData {
-            unsigned isNode : 1;
-            unsigned material : 7;
-            unsigned normal : 24;
-        };
-
-        union Node {
-            NodeBase base;
-            NodeData node;
-            LeafData leaf;
-            uint32_t raw;
-        };
-
-        std::vector<Node> data;
-    public:
-        struct Config{
-            uint8_t depth;
-        };
-
-        Octree(Config *config);
-        ~Octree();
-        void Update();
-
-        uint32_t lookup(glm::uvec3 position);
-        void insert(glm::uvec3 position, Node leaf);
-        void remove(glm::uvec3 position);
-
-        static uint32_t packedNormal(glm::vec3& normal);
-
-        uint8_t depth;
-        uint32_t capacity;
-        uint32_t size = 8;
-        uint32_t numVoxels = 0;
-
-        friend class Renderer;
-    private:
-        GLuint gl_ID;
-        GLuint program;
-        GLuint texBufferID;
-        GLuint depthUniformLocation;
-
-        std::stack<uint32_t> freeNodes;
-        
-        void setProgram(GLuint program_);
-        void GenUBO(GLuint program_);
-        void freeVRAM();
-        void BindUniforms(uint8_t &texturesBound);
-        void UpdateNode(uint32_t index);
-        void resizeDataIfNeeded(uint32_t requiredCapacity);
-
-        uint32_t utils_p2r[maxDepth];
-        uint32_t locate(glm::uvec3 position, uint32_t depth_);
-        bool contained(glm::uvec3 position1, glm::uvec3 position2, uint32_t depth_);
+#pragma once
+
+#include "core.hpp"
+
+#include <stack>
+#include <functional>
+#include <cstdlib>
+#include <shared_mutex>
+#include <memory>
+
+#define maxDepth 16
+
+class Renderer;
+class JobSystem;
+class Octree{
+    public:
+        struct NodeBase {
+            unsigned isNode : 1;
+        };
+
+        struct NodeData {
+            unsigned isNode : 1;
+            unsigned count : 3;
+            unsigned next : 28;
+        };
+
+        struct LeafData {
+            unsigned isNode : 1;
+            unsigned flags : 2;     //free per voxel bits, not read by the shaders yet
+            unsigned material : 13;
+            unsigned normal : 16;   //octahedral, see packedNormal
+        };
+
+        union Node {
+            NodeBase base;
+            NodeData node;
+            LeafData leaf;
+            uint32_t raw;
+        };
+
+        //down-sampled attributes of internal nodes for LOD traversal, parallel to data
+        struct Attribute {
+            unsigned normal : 16;   //coverage weighted average, packed like LeafData::normal
+            unsigned material : 16; //material of the children covering the most voxels
+            uint32_t coverage;      //solid voxels below the node
+        };
+
+        //CPU queries work in leaf units, the same space insert and remove take positions in
+        struct Ray {
+            glm::vec3 origin;
+            glm::vec3 direction;
+            float maxDistance;
+        };
+
+        //inclusive box of leaves
+        struct Region {
+            glm::uvec3 min;
+            glm::uvec3 max;
+        };
+
+        //solid leaf handed to the visitors, position and size in leaf units
+        struct Leaf {
+            uint32_t index;         //its node in data
+            glm::uvec3 position;    //lowest corner
+            uint32_t size;          //edge length, 1 at the bottom level
+            LeafData data;
+        };
+        typedef std::function<void(const Leaf&)> LeafVisitor;
+
+        struct RayHit {
+            bool hit;
+            float distance;         //ray parameter of the first contact
+            glm::uvec3 position;    //leaf that was hit
+            uint32_t index;         //its node in data
+            glm::vec3 normal;       //face the contact happened on, -direction when starting inside
+        };
+
+        //block layouts compact can write, both keep the root block first
+        enum Order {
+            BREADTH_FIRST,  //depth after depth, the top levels every ray reads share a few cache lines
+            DEPTH_FIRST     //every subtree's blocks back to back, a descent stays within a small span
+        };
+
+        //slot whose node/leaf state changed: split, merged, filled or emptied, depth and lowest corner in leaf units
+        struct SlotEdit {
+            uint32_t index;
+            uint32_t depth;
+            glm::uvec3 position;
+        };
+
+        //rewritten copy of the tree, built by compact and swapped in by install
+        struct Compaction {
+            std::vector<Node> data;
+            std::vector<Attribute> attributes;
+            std::vector<uint32_t> source;   //slot every new slot was copied from, occlusion is gathered through it on install
+            uint32_t size;
+            uint32_t capacity;
+            uint32_t revision;              //of the tree it was copied from
+            Order order;
+        };
+
+        std::vector<Node> data;
+        std::vector<Attribute> attributes;
+        std::vector<uint8_t> occlusion;     //baked ambient visibility of solid leaves, 255 when unoccluded
+        //neighbour links ("ropes") of every slot, 6 per slot at 2 * axis + 1 for the positive side: (slot << 4) | (depth - 1)
+        //of the deepest slot at most as deep that holds the cell across the face, NO_ROPE at the border, empty while disabled
+        std::vector<uint32_t> ropes;
+        static constexpr uint32_t NO_ROPE = UINT32_MAX;
+    public:
+        struct Config{
+            uint8_t depth;
+        };
+
+        Octree(Config *config);
+        ~Octree();
+        void Update();
+
+        uint32_t lookup(glm::uvec3 position);
+        void insert(glm::uvec3 position, Node leaf);
+        void remove(glm::uvec3 position);
+
+        //thread safe queries, they may run concurrently with each other and block only during insert/remove
+        RayHit raycast(const Ray &ray) const;
+        //splits the rays into chunks run on the workers, hits[i] answers rays[i]
+        void raycastBatch(JobSystem *jobs, const Ray *rays, RayHit *hits, size_t count) const;
+        //first contact of the box [min, max] moved along direction for at most maxDistance
+        RayHit sweepAABB(glm::vec3 min, glm::vec3 max, glm::vec3 direction, float maxDistance) const;
+        //solid leaves touching the box [min, max], appended to voxels when given
+        bool overlapAABB(glm::vec3 min, glm::vec3 max, std::vector<glm::uvec3> *voxels = nullptr) const;
+
+        //every solid leaf (or those touching region), depth first, the tree is read locked throughout so visit must not edit it
+        void forEachLeaf(const LeafVisitor &visit) const;
+        void forEachLeaf(const Region &region, const LeafVisitor &visit) const;
+        //the same split into disjoint subtrees of at most about grain leaves run on the workers, visit is called concurrently and in no order
+        void forEachLeafParallel(JobSystem *jobs, const LeafVisitor &visit, uint32_t grain = 4096) const;
+        void forEachLeafParallel(JobSystem *jobs, const Region &region, const LeafVisitor &visit, uint32_t grain = 4096) const;
+
+        //copies the blocks reachable from the root in order, remapping child links, free and orphaned blocks are left behind
+        //and capacity shrinks to the next power of two, a query that may run on a worker
+        std::shared_ptr<Compaction> compact(Order order) const;
+        //swaps a compaction in and uploads it whole, false when the tree was edited after it was copied
+        bool install(Compaction &compaction);
+
+        //builds the ropes over the whole tree and keeps them patched by insert/remove, or drops them
+        void setRopes(bool enabled);
+        bool hasRopes() const { return roped; }
+
+        //counts nodes, leaves and slot usage, leaves are counted on the workers
+        core::OctreeStats computeStats(JobSystem *jobs) const;
+
+        //internal nodes grouped by depth (index 0 is the top level) and solid leaves as (index, x, y, z)
+        void hierarchy(std::vector<std::vector<uint32_t>> &nodes, std::vector<glm::uvec4> &leaves);
+
+        //region touched by insert/remove since the last call, in leaf units, false when nothing changed
+        bool consumeEdits(glm::uvec3 &min, glm::uvec3 &max);
+        void setOcclusion(uint32_t index, uint8_t value);
+        //boxes around the leaves inserted or removed since the last call, a handful even for scattered edits
+        bool consumeDirtyRegions(std::vector<Region> &regions);
+        //slots changed by insert/remove since the last call, in edit order, only kept for the resident volume
+        bool consumeSlotEdits(std::vector<SlotEdit> &edits);
+        //replaces the normals of solid leaves, uploaded with the next FlushAttributes, returns how many changed
+        uint32_t setNormals(const std::vector<std::pair<glm::uvec3, uint32_t>> &normals);
+
+        static uint32_t packedNormal(glm::vec3& normal);
+        static glm::vec3 unpackedNormal(uint32_t packedNormal);
+
+        uint8_t depth;
+        uint32_t capacity;
+        uint32_t size = 8;
+        uint32_t numVoxels = 0;
+        uint32_t layoutRevision = 0;    //bumped when every node index changes, by install
+
+        friend class Renderer;
+        friend class InstanceScene;
+    private:
+        GLuint gl_ID;
+        GLuint program;
+        GLuint texBufferID;
+        GLuint depthUniformLocation;
+        GLuint attributeBufferID;
+        GLuint attributeTexBufferID;
+        GLuint occlusionBufferID;
+        GLuint occlusionTexBufferID;
+        uint32_t dirtyAttributesBegin = UINT32_MAX;
+        uint32_t dirtyAttributesEnd = 0;
+        uint32_t dirtyOcclusionBegin = UINT32_MAX;
+        uint32_t dirtyOcclusionEnd = 0;
+        uint32_t dirtyDataBegin = UINT32_MAX;  //leaves patched in place, other node writes go through UpdateNode
+        uint32_t dirtyDataEnd = 0;
+        GLuint ropeBufferID = 0;
+        GLuint ropeTexBufferID = 0;
+        uint32_t dirtyRopesBegin = UINT32_MAX;  //in slots
+        uint32_t dirtyRopesEnd = 0;
+        bool roped = false;
+
+        bool edited = false;
+        glm::uvec3 editMin, editMax;
+        std::vector<Region> dirtyRegions;
+        std::vector<SlotEdit> slotEdits;
+        void markSlot(uint32_t index, uint32_t depth_, glm::uvec3 position);
+        void markEdit(glm::uvec3 position);
+        void markShading(glm::uvec3 position);
+
+        bool modified = true;
+        bool resident = false;  //GPU buffers exist, octrees only used as instance models stay on the CPU
+        uint32_t revision = 0;  //bumped on every node write
+
+        std::stack<uint32_t> freeNodes;
+
+        mutable std::shared_mutex queryMutex;   //shared by queries, exclusive while insert/remove edit data
+        bool descend(glm::uvec3 position, uint32_t &index, uint32_t &size) const;
+        RayHit traverse(const Ray &ray, const glm::vec3 &inverse, float tEnter, float tExit) const;
+        void visitNode(uint32_t block, uint32_t depth_, glm::uvec3 origin, const Region &region, const LeafVisitor &visit) const;
+        Region everything() const;
+        bool overlapNode(uint32_t block, uint32_t depth_, glm::uvec3 origin, const glm::vec3 &min, const glm::vec3 &max, std::vector<glm::uvec3> *voxels) const;
+        static glm::vec3 inverseDirection(const glm::vec3 &direction);
+        
+        void setProgram(GLuint program_);
+        void GenUBO(GLuint program_);
+        void freeVRAM();
+        void BindUniforms(uint8_t &texturesBound, const core::PassUniforms &uniforms);
+        void UpdateNode(uint32_t index);
+        void resizeDataIfNeeded(uint32_t requiredCapacity);
+        void allocateVRAM();
+        void updateAttributes(const uint32_t *path, int length);
+        void FlushAttributes();
+        void allocateRopes();
+        uint32_t ropeTo(glm::uvec3 position, uint32_t depth_) const;
+        void ropeSubtree(uint32_t slot, uint32_t depth_);
+        void patchRopes(uint32_t slot, uint32_t depth_, glm::uvec3 position);
+
+        uint32_t utils_p2r[maxDepth];
+        uint32_t locate(glm::uvec3 position, uint32_t depth_) const;
+        bool contained(glm::uvec3 position1, glm::uvec3 position2, uint32_t depth_);
 };
\ No newline at end of file
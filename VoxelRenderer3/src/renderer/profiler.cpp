@@ -0,0 +1,103 @@
+#include "profiler.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+
+std::atomic<bool> Profiler::enabled(true);
+std::mutex Profiler::threadsLock;
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>> Profiler::threads;
+uint64_t Profiler::frameMark = 0;
+
+static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+//never 0, a zone start of 0 means it was opened while disabled
+uint64_t Profiler::now(){
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count() + 1;
+}
+
+//the buffer outlives its thread so the events of finished workers still end up in dumps
+Profiler::ThreadBuffer *Profiler::local(){
+    thread_local ThreadBuffer *buffer = nullptr;
+    if(!buffer){
+        std::lock_guard<std::mutex> guard(threadsLock);
+        threads.emplace_back(new ThreadBuffer());
+        buffer = threads.back().get();
+        buffer->id = threads.size();
+        buffer->name = "thread " + std::to_string(buffer->id);
+        buffer->events.resize(capacity);
+        buffer->head = 0;
+    }
+    return buffer;
+}
+
+void Profiler::record(const char *name, uint64_t start, uint64_t end){
+    ThreadBuffer *buffer = local();
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    buffer->events[head & (capacity - 1)] = {name, start, end};
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char *name){
+    ThreadBuffer *buffer = local();
+    std::lock_guard<std::mutex> guard(threadsLock);
+    buffer->name = name;
+}
+
+template<typename F> void Profiler::visit(ThreadBuffer &buffer, uint64_t since, F f){
+    const uint64_t margin = 256;
+    uint64_t head = buffer.head.load(std::memory_order_acquire);
+    uint64_t oldest = head > capacity - margin ? head - (capacity - margin) : 0;
+    for(uint64_t i = head; i > oldest; i--){
+        const Event &event = buffer.events[(i - 1) & (capacity - 1)];
+        //events are recorded as zones end, so they are ordered by end time
+        if(event.end <= since)
+            break;
+        f(event);
+    }
+}
+
+void Profiler::frame(std::vector<std::pair<const char*, float>> &totals){
+    for(std::pair<const char*, float> &total : totals)
+        total.second = 0.0f;
+
+    uint64_t since = frameMark;
+    frameMark = now();
+
+    std::lock_guard<std::mutex> guard(threadsLock);
+    for(std::unique_ptr<ThreadBuffer> &buffer : threads){
+        visit(*buffer, since, [&](const Event &event){
+            if(event.end > frameMark)
+                return;
+            size_t i = 0;
+            while(i < totals.size() && totals[i].first != event.name && strcmp(totals[i].first, event.name) != 0)
+                i++;
+            if(i == totals.size())
+                totals.push_back({event.name, 0.0f});
+            totals[i].second += (float)((double)(event.end - event.start) / 1e6);
+        });
+    }
+}
+
+bool Profiler::dump(const char *path, double seconds){
+    FILE *file = fopen(path, "w");
+    if(!file)
+        return false;
+
+    uint64_t end = now();
+    uint64_t since = end > (uint64_t)(seconds * 1e9) ? end - (uint64_t)(seconds * 1e9) : 0;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    std::lock_guard<std::mutex> guard(threadsLock);
+    for(std::unique_ptr<ThreadBuffer> &buffer : threads){
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", buffer->id, buffer->name.c_str());
+        first = false;
+        visit(*buffer, since, [&](const Event &event){
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                event.name, buffer->id, (double)event.start / 1000.0, (double)(event.end - event.start) / 1000.0);
+        });
+    }
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+
+// Scoped CPU zones. Every thread records into its own ring buffer without taking a lock,
+// the buffers are summed up once per frame for the ImGui plots and dumped as Chrome trace
+// events (chrome://tracing or Perfetto) on demand. Disabled zones cost a single flag load,
+// defining PROFILER_DISABLED compiles them out entirely.
+class Profiler{
+    public:
+        struct Event{
+            const char *name;   //string literal, compared by pointer first
+            uint64_t start;     //ns since the profiler started
+            uint64_t end;
+        };
+
+        struct Zone{
+            explicit Zone(const char *name_) : name(name_), start(enabled.load(std::memory_order_relaxed) ? now() : 0){}
+            ~Zone(){ if(start) record(name, start, now()); }
+            const char *name;
+            uint64_t start;     //0 when the profiler was disabled on entry
+        };
+
+        static std::atomic<bool> enabled;
+
+        static uint64_t now();
+        static void record(const char *name, uint64_t start, uint64_t end);
+        static void setThreadName(const char *name);
+
+        //total ms of every zone that ended since the previous call, merged across threads
+        static void frame(std::vector<std::pair<const char*, float>> &totals);
+        //writes the events of the last seconds, as far back as the ring buffers reach
+        static bool dump(const char *path, double seconds);
+
+    private:
+        static const uint32_t capacity = 1 << 15;  //events per thread
+
+        struct ThreadBuffer{
+            std::string name;
+            uint32_t id;
+            std::vector<Event> events;
+            std::atomic<uint64_t> head;     //events ever written, only the owner thread writes
+        };
+
+        static std::mutex threadsLock;
+        static std::vector<std::unique_ptr<ThreadBuffer>> threads;
+        static uint64_t frameMark;
+
+        static ThreadBuffer *local();
+        //visits the events of buffer ending after since, skips slots the owner may be overwriting
+        template<typename F> static void visit(ThreadBuffer &buffer, uint64_t since, F f);
+};
+
+#ifndef PROFILER_DISABLED
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
@@ -1,510 +1,1420 @@
-#include "renderer.hpp"
-#include <stdio.h>
-#include <string.h>
-
-
-Renderer::Renderer(core::RendererConfig *config_, Octree *volume_, Camera *camera_, MaterialPool *materialPool_) : config(config_), volume(volume_), camera(camera_), materialPool(materialPool_){
-
-    lBuffer.stride = 10;//fixed size, determines the slot layout used in the pipeline
-    lBuffer.instruction = 1;
-    if(config->lBufferSize.x == -1)
-        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &config->lBufferSize.x);
-    if(config->lBufferSize.y == -1)
-        config->lBufferSize.y = 1<<((volume->depth-4) <= 1 ? 1 : (volume->depth-4));
-
-    lBuffer.size.x = config->lBufferSize.x;
-    lBuffer.slots = config->lBufferSize.y; //variable size, determines the number of voxel slots in the lighting buffer
-    lBuffer.size.y = lBuffer.stride * lBuffer.slots;
-
-    if(config->debuggingEnabled)config->logMessage("[%f] initializing the renderer \n", glfwGetTime());
-    checkGLError(&success);
-
-    linkRaster(&rayPass, "./shd/ray.vert", "./shd/ray.frag");
-    linkCompute(&accumPass, "./shd/accum.comp");
-    linkCompute(&avgPass, "./shd/avg.comp");
-    linkRaster(&finalPass, "./shd/final.vert", "./shd/final.frag");
-
-    if(config->debuggingEnabled)config->logMessage("[%f] compiled shaders \n", glfwGetTime());
-    checkGLError(&success);
-
-    camera->GenUBO(rayPass.program);
-    volume->GenUBO(rayPass.program);
-    materialPool->GenUBO(rayPass.program);
-
-    rrm.displaySize = config->framebufferSize();
-
-
-    float *textureQuad = genQuad(glm::vec2(1.0f, 1.0f), glm::vec2(1.0f, 1.0f));
-
-    
-    glGenVertexArrays(1, &finalPass.VAO);
-    glGenBuffers(1, &finalPass.VBO);
-    glBindVertexArray(finalPass.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, finalPass.VBO);
-    glBufferData(GL_ARRAY_BUFFER, 24 * sizeof(float), textureQuad, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-
-    glGenVertexArrays(1, &rayPass.VAO);
-    glGenBuffers(1, &rayPass.VBO);
-    glBindVertexArray(rayPass.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, rayPass.VBO);
-    glBufferData(GL_ARRAY_BUFFER, 24 * sizeof(float), textureQuad, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-
-    if(config->debuggingEnabled)config->logMessage("[%f] generated Quad Vertex Array Objects \n", glfwGetTime());
-    checkGLError(&success);
-
-    glGenTextures(1, &avgPass.texture);
-    
-    glGenFramebuffers(1, &rayPass.framebuffer);
-    glGenTextures(1, &rayPass.texture);
-    glGenRenderbuffers(1, &rayPass.rbo);
-
-    glGenFramebuffers(1, &finalPass.framebuffer);
-    glGenTextures(1, &finalPass.texture);
-    glGenRenderbuffers(1, &finalPass.rbo);
-
-    if(config->debuggingEnabled)config->logMessage("[%f] building lighting buffer \n", glfwGetTime());
-    checkGLError(&success);
-
-    glGenTextures(1, &lBuffer.texture);
-    glBindTexture(GL_TEXTURE_2D, lBuffer.texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, lBuffer.size.x, lBuffer.size.y, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    if(config->debuggingEnabled)config->logMessage("[%f] built lighting buffer \n", glfwGetTime());
-    checkGLError(&success);
-
-    framebufferEvent();
-
-    if(config->debuggingEnabled)config->logMessage("[%f] generated all framebuffer objects \n", glfwGetTime());
-    checkGLError(&success);
-}
-
-bool Renderer::run(core::FrameConfig *frameConfig){
-    
-    debug.gpu_start_ms = glfwGetTime() * 1000.0;
-    debug.start_ms = debug.end_ms;
-    debug.end_ms = glfwGetTime() * 1000.0;
-
-    debug.scene_capacity = volume->capacity * sizeof(Octree::Node);
-    debug.scene_mem = volume->size * sizeof(Octree::Node);
-    debug.lBuffer_mem = lBuffer.size.x * lBuffer.size.y * sizeof(GLuint);
-
-    debug.voxels_num = volume->numVoxels;
-    debug.cam_position = camera->position;
-    debug.cam_direction = camera->direction;
-
-    handleShaderRecompilation(frameConfig);
-
-    debug.gpu_shaderCompilation_ms = glfwGetTime() * 1000.0;
-
-    glm::ivec2 displayComparaison = rrm.displaySize;
-    rrm.displaySize = config->framebufferSize();
-
-    if(rrm.displaySize != displayComparaison){
-        framebufferEvent();
-        if(config->debuggingEnabled)config->logMessage("[%f] framebuffer resized \n", glfwGetTime());
-        checkGLError(&success);
-    }
-
-    debug.gpu_framebufferResize_ms = glfwGetTime() * 1000.0;
-    
-    //rayPass
-
-    // Set the viewport
-    glViewport(0, 0, rrm.framebufferSize.x, rrm.framebufferSize.y);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, rayPass.framebuffer);
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-    
-    glUseProgram(rayPass.program);
-
-    {
-        rrm.texturesBound = 0;
-        volume->BindUniforms(rrm.texturesBound);
-        
-        GLint resLoc = glGetUniformLocation(rayPass.program, "screenResolution");
-        GLint timeLoc = glGetUniformLocation(rayPass.program, "time");
-        GLint sppLoc = glGetUniformLocation(rayPass.program, "spp");
-        GLint bouncesLoc = glGetUniformLocation(rayPass.program, "lightBounces");
-        GLint checksLoc = glGetUniformLocation(rayPass.program, "controlchecks");
-
-        glUniform2i(resLoc, rrm.framebufferSize.x, rrm.framebufferSize.y);
-        glUniform1i(timeLoc, (int)(glfwGetTime()*10000));
-        glUniform1i(sppLoc, frameConfig->spp);
-        glUniform1i(bouncesLoc, frameConfig->bounces);
-        glUniform1ui(checksLoc, (GLuint)frameConfig->controlchecks);
-    }
-
-    glBindVertexArray(rayPass.VAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-
-    debug.gpu_pass1_ms = glfwGetTime() * 1000.0;
-    if(config->debuggingEnabled)config->logMessage("[%f] pass 1 \n", glfwGetTime());
-    checkGLError(&success);
-
-    //accumPass
-
-    #define ADDLEFT 1
-    #define ADDRIGHT 2
-    #define ADDCLEARLEFT 3
-    #define ADDCLEARRIGHT 4
-
-    glUseProgram(accumPass.program);
-    glBindImageTexture(0, rayPass.texture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA32F);
-    glBindImageTexture(1, lBuffer.texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
-    {
-        GLint resLoc = glGetUniformLocation(accumPass.program, "screenResolution");
-        GLint slotsLoc = glGetUniformLocation(accumPass.program, "slots");
-        GLint strideLoc = glGetUniformLocation(accumPass.program, "stride");
-        GLint timeLoc = glGetUniformLocation(accumPass.program, "time");
-        GLint updateLoc = glGetUniformLocation(accumPass.program, "updateTime");
-        GLint sizeLoc = glGetUniformLocation(accumPass.program, "size");
-
-        glUniform2i(resLoc, rrm.framebufferSize.x, rrm.framebufferSize.y);
-        glUniform1i(slotsLoc, lBuffer.slots);
-        glUniform1i(strideLoc, lBuffer.stride);
-        glUniform1i(sizeLoc, lBuffer.size.x);
-        glUniform1ui(timeLoc, (GLuint)(glfwGetTime()*100));
-        glUniform1ui(updateLoc, (GLuint)(2.0 * (debug.end_ms - debug.start_ms)));
-
-        GLint instructionLoc = glGetUniformLocation(accumPass.program, "instruction");
-        if(glfwGetTime() - lBuffer.accumulationTime > frameConfig->lBufferSwapSeconds && !(frameConfig->TAA)){
-            lBuffer.accumulationTime = glfwGetTime();
-            switch(lBuffer.instruction){
-                case ADDRIGHT:
-                    glUniform1i(instructionLoc, ADDCLEARLEFT);
-                    lBuffer.instruction = ADDLEFT;
-                    break;
-                case ADDLEFT:
-                    glUniform1i(instructionLoc, ADDCLEARRIGHT);
-                    lBuffer.instruction = ADDRIGHT;
-                    break;
-            }
-        }else{
-            glUniform1i(instructionLoc, lBuffer.instruction);
-        }
-    }
-    glDispatchCompute((GLuint)ceil((float)accumPass.globalSize.x / (float)accumPass.groupSize.x), (GLuint)ceil((float)accumPass.globalSize.y / (float)accumPass.groupSize.y), 1);
-    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-
-    debug.gpu_pass2_ms = glfwGetTime() * 1000.0;
-    if(config->debuggingEnabled)config->logMessage("[%f] pass 2 \n", glfwGetTime());
-    checkGLError(&success);
-
-    //avgPass
-
-    glUseProgram(avgPass.program);
-    glBindImageTexture(0, lBuffer.texture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32UI);
-    glBindImageTexture(1, rayPass.texture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA32F);
-    glBindImageTexture(2, avgPass.texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
-    {
-        GLint resLoc = glGetUniformLocation(avgPass.program, "screenResolution");
-        GLint slotsLoc = glGetUniformLocation(avgPass.program, "slots");
-        GLint strideLoc = glGetUniformLocation(avgPass.program, "stride");
-        GLint sizeLoc = glGetUniformLocation(avgPass.program, "size");
-
-        glUniform2i(resLoc, rrm.framebufferSize.x, rrm.framebufferSize.y);
-        glUniform1i(slotsLoc, lBuffer.slots);
-        glUniform1i(strideLoc, lBuffer.stride);
-        glUniform1i(sizeLoc, lBuffer.size.x);
-    }
-    glDispatchCompute((GLuint)ceil((float)avgPass.globalSize.x / (float)avgPass.groupSize.x), (GLuint)ceil((float)avgPass.globalSize.y / (float)avgPass.groupSize.y), 1);
-    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-
-    debug.gpu_pass3_ms = glfwGetTime() * 1000.0;
-    if(config->debuggingEnabled)config->logMessage("[%f] pass 3 \n", glfwGetTime());
-    checkGLError(&success);
-
-    //finalPass
-
-    // Set the viewport
-    glViewport(rrm.framebufferPos.x, rrm.framebufferPos.y, rrm.framebufferSize.x, rrm.framebufferSize.y);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    if(frameConfig->renderToTexture)
-        glBindFramebuffer(GL_FRAMEBUFFER, finalPass.framebuffer);
-    glDisable(GL_DEPTH_TEST); // disable depth test so screen-space quad isn't discarded due to depth test.
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glUseProgram(finalPass.program);
-
-    {
-        GLint resLoc = glGetUniformLocation(finalPass.program, "screenResolution");
-        glUniform2i(resLoc, rrm.framebufferSize.x, rrm.framebufferSize.y);
-    }
-
-    glBindVertexArray(finalPass.VAO);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, avgPass.texture);    // use the color attachment texture as the texture of the quad plane
-    glUniform1i(glGetUniformLocation(finalPass.program, "screenTexture"), 0);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-
-    // Unbind the textures after drawing
-    glBindTexture(GL_TEXTURE_BUFFER, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    debug.gpu_end_ms = glfwGetTime() * 1000.0;
-    if(config->debuggingEnabled)config->logMessage("[%f] frame end \n", glfwGetTime());
-    checkGLError(&success);
-
-    return success; 
-}
-
-Renderer::~Renderer(){
-    camera->freeVRAM();
-    volume->freeVRAM();
-    materialPool->freeVRAM();
-
-    glDeleteVertexArrays(1, &finalPass.VAO);
-    glDeleteBuffers(1, &finalPass.VBO);
-
-    glDeleteVertexArrays(1, &rayPass.VAO);
-    glDeleteBuffers(1, &rayPass.VBO);
-    glDeleteTextures(1, &rayPass.texture);
-    glDeleteTextures(1, &lBuffer.texture);
-    glDeleteTextures(1, &avgPass.texture);
-    glDeleteRenderbuffers(1, &rayPass.rbo);
-    glDeleteFramebuffers(1, &rayPass.framebuffer);
-
-    glDeleteProgram(rayPass.program);
-    glDeleteProgram(accumPass.program);
-    glDeleteProgram(accumPass.program);
-    glDeleteProgram(finalPass.program);
-}
-
-float* Renderer::genQuad(glm::vec2 size, glm::vec2 tex){
-    float *quadVertices = new float[24]{
-        -size.x,  size.y,  0.0f, tex.y,
-        -size.x, -size.y,  0.0f,  0.0f,
-         size.x, -size.y,  tex.x, 0.0f,
-
-        -size.x,  size.y,  0.0f,  tex.y,
-         size.x, -size.y,  tex.x, 0.0f,
-         size.x,  size.y,  tex.x, tex.y
-    };
-    return quadVertices;
-}
-
-void Renderer::framebufferEvent(){
-
-    // Calculate the aspect ratio of the window
-    float windowAspect = (float)rrm.displaySize.x / (float)rrm.displaySize.y;
-
-    if (windowAspect > config->aspectRatio) {
-        // Window is wider than desired aspect ratio
-        rrm.framebufferSize.y = rrm.displaySize.y;
-        rrm.framebufferSize.x = static_cast<int>(rrm.displaySize.y * config->aspectRatio);
-        rrm.framebufferPos.x = (rrm.displaySize.x - rrm.framebufferSize.x) / 2;
-        rrm.framebufferPos.y = 0;
-    } else {
-        // Window is taller than desired aspect ratio
-        rrm.framebufferSize.x = rrm.displaySize.x;
-        rrm.framebufferSize.y = static_cast<int>(rrm.displaySize.x / config->aspectRatio);
-        rrm.framebufferPos.x = 0;
-        rrm.framebufferPos.y = (rrm.displaySize.y - rrm.framebufferSize.y) / 2;
-    }
-
-    accumPass.globalSize = glm::ivec2(rrm.framebufferSize.x, rrm.framebufferSize.y);
-    accumPass.groupSize = glm::ivec2(8, 8);
-    avgPass.globalSize = glm::ivec2(rrm.framebufferSize.x, rrm.framebufferSize.y);
-    avgPass.groupSize = glm::ivec2(8, 8);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, rayPass.framebuffer);
-    glBindTexture(GL_TEXTURE_2D, rayPass.texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, rrm.framebufferSize.x, rrm.framebufferSize.y, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, rayPass.texture, 0);
-
-    glBindRenderbuffer(GL_RENDERBUFFER, rayPass.rbo);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, rrm.framebufferSize.x, rrm.framebufferSize.y); // depth and stencil buffer
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rayPass.rbo); // attach it
-
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        config->logMessage("RENDERER::ERROR::FRAMEBUFFER:: Framebuffer is not complete! \n");
-
-    glBindFramebuffer(GL_FRAMEBUFFER, finalPass.framebuffer);
-    glBindTexture(GL_TEXTURE_2D, finalPass.texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, rrm.framebufferSize.x, rrm.framebufferSize.y, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, finalPass.texture, 0);
-
-    glBindRenderbuffer(GL_RENDERBUFFER, finalPass.rbo);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, rrm.framebufferSize.x, rrm.framebufferSize.y); // depth and stencil buffer
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, finalPass.rbo); // attach it
-
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        config->logMessage("RENDERER::ERROR::FRAMEBUFFER:: Framebuffer is not complete! \n");
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    glBindTexture(GL_TEXTURE_2D, avgPass.texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, rrm.framebufferSize.x, rrm.framebufferSize.y, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
-
-void Renderer::handleShaderRecompilation(core::FrameConfig *frameConfig){
-    if(currentRenderType != frameConfig->renderType){
-        switch (frameConfig->renderType)
-        {
-        case core::RenderType::DEFAULT :
-            relinkRaster(&rayPass, "./shd/ray.vert", "./shd/ray.frag");
-            volume->setProgram(rayPass.program);
-            camera->setProgram(rayPass.program);
-            materialPool->setProgram(rayPass.program);
-            break;
-        case core::RenderType::NORMAL :
-            relinkRaster(&rayPass, "./shd/ray.vert", "./shd/normal_ray.frag");
-            volume->setProgram(rayPass.program);
-            camera->setProgram(rayPass.program);
-            materialPool->setProgram(rayPass.program);
-            break;
-        case core::RenderType::STRUCTURE :
-            relinkRaster(&rayPass, "./shd/ray.vert", "./shd/accel_struct_ray.frag");
-            volume->setProgram(rayPass.program);
-            camera->setProgram(rayPass.program);
-            materialPool->setProgram(rayPass.program);
-            break;     
-        case core::RenderType::ALBEDO :
-            relinkRaster(&rayPass, "./shd/ray.vert", "./shd/albedo_ray.frag");
-            volume->setProgram(rayPass.program);
-            camera->setProgram(rayPass.program);
-            materialPool->setProgram(rayPass.program);
-            break;    
-        case core::RenderType::VOXELID :
-            relinkRaster(&rayPass, "./shd/ray.vert", "./shd/voxelid_ray.frag");
-            volume->setProgram(rayPass.program);
-            camera->setProgram(rayPass.program);
-            materialPool->setProgram(rayPass.program);
-            break;    
-        }
-        currentRenderType = frameConfig->renderType;
-        frameConfig->TAA = false;
-        if(config->debuggingEnabled)config->logMessage("[%f] recompiled shaders \n", glfwGetTime());
-        checkGLError(&success);
-    }
-
-    if(frameConfig->shaderRecompilation){
-        relinkRaster(&rayPass, "./shd/ray.vert", "./shd/ray.frag");
-        volume->setProgram(rayPass.program);
-        camera->setProgram(rayPass.program);
-        materialPool->setProgram(rayPass.program);
-        relinkCompute(&accumPass, "./shd/accum.comp");
-        relinkCompute(&avgPass, "./shd/avg.comp");
-        //relinkRaster(&rayPass, "./shd/final.vert", "./shd/final.frag");
-        frameConfig->shaderRecompilation = false;
-        frameConfig->TAA = false;
-        if(config->debuggingEnabled)config->logMessage("[%f] recompiled shaders \n", glfwGetTime());
-        checkGLError(&success);
-    }
-}
-
-void Renderer::linkCompute(core::ComputePass *pass, const char *shaderFile){
-    pass->shader = compileShader(shaderFile, "COMPUTE", GL_COMPUTE_SHADER);
-    pass->program = glCreateProgram();
-    glAttachShader(pass->program, pass->shader);
-    glLinkProgram(pass->program);
-    glDeleteShader(pass->shader);
-    checkProgramCompileErrors(pass->program);
-}
-
-void Renderer::linkRaster(core::RasterPass *pass, const char *vertexFile, const char *fragmentFile){
-    pass->vertexShader = compileShader(vertexFile, "VERTEX", GL_VERTEX_SHADER);
-    pass->fragmentShader = compileShader(fragmentFile, "FRAGMENT", GL_FRAGMENT_SHADER);
-    pass->program = glCreateProgram();
-    glAttachShader(pass->program, pass->vertexShader);
-    glAttachShader(pass->program, pass->fragmentShader);
-    glLinkProgram(pass->program);
-    glDeleteShader(pass->vertexShader);
-    glDeleteShader(pass->fragmentShader);
-    checkProgramCompileErrors(pass->program);
-}
-
-GLuint Renderer::compileShader(const char* path, std::string type, GLuint gl_type){
-    //Read shader from disk
-    std::string shaderCodeRaw;
-    std::ifstream shaderFile;
-    shaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-    try 
-    {
-        shaderFile.open(path);
-        std::stringstream shaderStream;
-        shaderStream << shaderFile.rdbuf();
-        shaderFile.close();
-        shaderCodeRaw = shaderStream.str();
-    }
-    catch (std::ifstream::failure& e)
-    {
-        if(config->debuggingEnabled)config->logMessage("[%f] RENDERER::ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: %s \n", glfwGetTime(), e.what());
-    }
-    const char* shaderCode = shaderCodeRaw.c_str();
-
-    //compile shader
-    GLuint shader = glCreateShader(gl_type);
-    glShaderSource(shader, 1, &shaderCode, NULL);
-    glCompileShader(shader);
-    int success_s;
-    char infoLog[1024];
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success_s);
-    if(success_s) return shader;
-    glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-    config->logMessage("[%f] RENDERER::SHADER_COMPILATION_ERROR\n %s \n", glfwGetTime(), infoLog);
-    return shader;
-}
-
-void Renderer::relinkCompute(core::ComputePass *pass, const char *shaderFile){
-    pass->shader = compileShader(shaderFile, "COMPUTE", GL_COMPUTE_SHADER);
-    GLuint newProgram = glCreateProgram();
-    glAttachShader(newProgram, pass->shader);
-    glLinkProgram(newProgram);
-    checkProgramCompileErrors(newProgram);
-    glDeleteProgram(pass->program);
-    pass->program = newProgram;
-}
-
-void Renderer::relinkRaster(core::RasterPass *pass, const char *vertexFile, const char *fragmentFile){
-    pass->vertexShader = compileShader(vertexFile, "VERTEX", GL_VERTEX_SHADER);
-    pass->fragmentShader = compileShader(fragmentFile, "FRAGMENT", GL_FRAGMENT_SHADER);
-    GLuint newProgram = glCreateProgram();
-    glAttachShader(newProgram, pass->vertexShader);
-    glAttachShader(newProgram, pass->fragmentShader);
-    glLinkProgram(newProgram);
-    checkProgramCompileErrors(newProgram);
-    glDeleteProgram(pass->program);
-    pass->program = newProgram;
-}
-
-void Renderer::checkProgramCompileErrors(unsigned int program)
-{
-    int success;
-    char infoLog[1024];
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if(success) return;
-    glGetProgramInfoLog(program, 1024, NULL, infoLog);
-    config->logMessage("[%f] RENDERER::PROGRAM_LINKING_ERROR \n %s \n", glfwGetTime(), infoLog);
-}
-
-void Renderer::checkGLError(bool *success_s){
-    GLenum error;
-    while((error = glGetError()) != GL_NO_ERROR)
-    {
-        config->logMessage("[%f] RENDERER::OPENGL_ERROR: %u \n", glfwGetTime(), (unsigned int)error);
-        *success_s = false;
-    }
-}
+#include "renderer.hpp"
+#include "lightinghash.hpp"
+#include "occlusion.hpp"
+#include "normals.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#define BEAM_TILE 8 //pixels per side of a beam pre-pass tile
+#define FRAME_UBO_BINDING 2 //after CameraUniform (0), 1 is free since the materials moved to a storage buffer
+#define RELOAD_POLL_SECONDS 0.5 //shader file time polling where inotify is missing
+#define CAPTURE_RING 4 //pixel pack buffers, a frame is mapped two or three frames after its copy
+#define OCTREE_STATS_SECONDS 1.0 //live octree statistics are recounted at most this often
+#define COMPACT_SETTLE_FRAMES 120 //frames after a compaction before the ray pass average is compared
+#define NORMAL_TILE 32 //leaves per side of one normal estimation job
+#define LBUFFER_STREAM "./lbuffer_stream.bin" //recorded voxel id frames, see LightingHashTable::appendStream
+#define LBUFFER_REPLAY_TICKS 2 //lighting clock ticks (10ms) between replayed frames, streams keep no times
+
+//lighting buffer instructions, which half of an entry accumulates and whether the other one is cleared first
+#define ADDLEFT 1
+#define ADDRIGHT 2
+#define ADDCLEARLEFT 3
+#define ADDCLEARRIGHT 4
+
+//names of the core::Uniform slots, in the same order
+static const char *uniformNames[core::UNIFORM_COUNT] = {
+    "octreeTexture",
+    "octreeDepth",
+    "attributeTexture",
+    "occlusionTexture",
+    "modelTexture",
+    "instanceCount",
+    "beamTexture",
+    "screenTexture",
+    "leafCount",
+    "leafOffset",
+    "budget",
+    "levelOffset",
+    "levelSize",
+    "ropeTexture",
+    "useRopes"
+};
+
+
+Renderer::Renderer(core::RendererConfig *config_, Octree *volume_, Camera *camera_, MaterialPool *materialPool_, InstanceScene *instances_, JobSystem *jobs_) : config(config_), graph(config_), volume(volume_), camera(camera_), materialPool(materialPool_), instances(instances_), jobs(jobs_){
+
+    lBuffer.stride = 10;//fixed size, determines the entry layout used in the pipeline
+    lBuffer.instruction = 1;
+    GLint maxTextureSize;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    if(config->lBufferSize.x == -1)
+        config->lBufferSize.x = maxTextureSize;
+    if(config->lBufferSize.y == -1)
+        config->lBufferSize.y = 1<<((volume->depth-4) <= 1 ? 1 : (volume->depth-4));
+
+    //power of two sizes turn the hash into a mask and the entry into a column/row split
+    lBuffer.width = LightingHashTable::floorPow2(std::min(config->lBufferSize.x, maxTextureSize));
+    lBuffer.rows = LightingHashTable::floorPow2(std::min(config->lBufferSize.y, maxTextureSize / lBuffer.stride));
+    lBuffer.capacity = lBuffer.width * lBuffer.rows;
+    lBuffer.maxProbe = config->lBufferMaxProbe;
+    lBuffer.evictAge = config->lBufferEvictAge;
+    lBuffer.size.x = lBuffer.width;
+    lBuffer.size.y = lBuffer.stride * lBuffer.rows;
+
+    lModel = new LightingHashTable({
+        .width = lBuffer.width,
+        .rows = lBuffer.rows,
+        .maxProbe = lBuffer.maxProbe,
+        .evictAge = lBuffer.evictAge
+    });
+
+    occlusionBaker = new OcclusionBaker({
+        .rays = config->occlusionRays,
+        .radius = config->occlusionRadius
+    }, jobs);
+
+    normalBaker = new NormalBaker({
+        .radius = config->normalRadius,
+        .tile = NORMAL_TILE
+    }, jobs);
+
+    capture = new Capture({
+        .ring = CAPTURE_RING
+    }, config, jobs);
+
+    if(config->debuggingEnabled)config->logMessage("[%f] initializing the renderer \n", glfwGetTime());
+    checkGLError(&success);
+
+    linkRaster(&rayPass, "./shd/ray.vert", "./shd/ray.frag");
+    linkCompute(&accumPass, "./shd/accum.comp");
+    linkCompute(&avgPass, "./shd/avg.comp");
+    linkCompute(&progPass, "./shd/progressive.comp");
+    linkCompute(&beamPass, "./shd/beam.comp");
+    linkCompute(&injectPass, "./shd/inject.comp");
+    linkCompute(&filterPass, "./shd/cone_filter.comp");
+    linkRaster(&finalPass, "./shd/final.vert", "./shd/final.frag");
+
+    if(config->debuggingEnabled)config->logMessage("[%f] compiled shaders \n", glfwGetTime());
+    checkGLError(&success);
+
+    reloader = new ShaderReloader({
+        .directory = "./shd",
+        .pollSeconds = RELOAD_POLL_SECONDS
+    }, config);
+    rayReload = watchRaster(&rayPass, "./shd/ray.vert", "./shd/ray.frag");
+    watchCompute(&accumPass, "./shd/accum.comp");
+    watchCompute(&avgPass, "./shd/avg.comp");
+    watchCompute(&progPass, "./shd/progressive.comp");
+    watchCompute(&beamPass, "./shd/beam.comp");
+    watchCompute(&injectPass, "./shd/inject.comp");
+    watchCompute(&filterPass, "./shd/cone_filter.comp");
+    watchRaster(&finalPass, "./shd/final.vert", "./shd/final.frag");
+
+    camera->GenUBO(rayPass.program);
+    volume->GenUBO(rayPass.program);
+    materialPool->GenBuffers();
+    instances->GenBuffers();
+
+    //values that only change with the lighting buffer layout, the rest is written every frame
+    frameUniforms.stride = lBuffer.stride;
+    frameUniforms.widthShift = LightingHashTable::log2(lBuffer.width);
+    frameUniforms.capacityMask = lBuffer.capacity - 1;
+    frameUniforms.maxProbe = lBuffer.maxProbe;
+    frameUniforms.evictAge = lBuffer.evictAge;
+
+    glGenBuffers(1, &frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(core::FrameUniforms), &frameUniforms, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UBO_BINDING, frameUBO);
+
+    rrm.displaySize = config->framebufferSize();
+
+
+    float *textureQuad = genQuad(glm::vec2(1.0f, 1.0f), glm::vec2(1.0f, 1.0f));
+
+    
+    glGenVertexArrays(1, &finalPass.VAO);
+    glGenBuffers(1, &finalPass.VBO);
+    glBindVertexArray(finalPass.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, finalPass.VBO);
+    glBufferData(GL_ARRAY_BUFFER, 24 * sizeof(float), textureQuad, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    glGenVertexArrays(1, &rayPass.VAO);
+    glGenBuffers(1, &rayPass.VBO);
+    glBindVertexArray(rayPass.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, rayPass.VBO);
+    glBufferData(GL_ARRAY_BUFFER, 24 * sizeof(float), textureQuad, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    if(config->debuggingEnabled)config->logMessage("[%f] generated Quad Vertex Array Objects \n", glfwGetTime());
+    checkGLError(&success);
+
+    //the progressive mean/variance stay RGBA32F to accumulate precisely, the frame itself is in half floats
+    meanTexture = graph.persistent("progressive mean", {.format = GL_RGBA32F, .divisor = 1, .filter = GL_LINEAR});
+    varianceTexture = graph.persistent("progressive variance", {.format = GL_RGBA32F, .divisor = 1, .filter = GL_NEAREST});
+    finalTexture = graph.persistent("final", {.format = GL_RGBA16F, .divisor = 1, .filter = GL_LINEAR});
+
+    genCounters(&pBuffer.counters, 1);
+
+    if(config->debuggingEnabled)config->logMessage("[%f] building lighting buffer \n", glfwGetTime());
+    checkGLError(&success);
+
+    glGenTextures(1, &lBuffer.texture);
+    glBindTexture(GL_TEXTURE_2D, lBuffer.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, lBuffer.size.x, lBuffer.size.y, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    {
+        //empty keys mark free entries, so the table has to start zeroed
+        GLuint zero = 0;
+        glClearTexImage(lBuffer.texture, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    }
+
+    genCounters(&lBuffer.stats, 5);
+    genCounters(&lBuffer.occupancy, 1);
+    beginCounting(&lBuffer.occupancy);
+    genCounters(&traversalStats, 2);
+    glGenQueries(1, &accumTimer.query);
+    glGenQueries(1, &avgTimer.query);
+    glGenQueries(1, &beamTimer.query);
+    glGenQueries(1, &coneTimer.query);
+    glGenQueries(1, &rayTimer.query);
+
+    glGenBuffers(1, &cBuffer.radianceBuffer);
+    glGenBuffers(1, &cBuffer.leafBuffer);
+    glGenBuffers(1, &cBuffer.nodeBuffer);
+
+    if(config->debuggingEnabled)config->logMessage("[%f] built lighting buffer \n", glfwGetTime());
+    checkGLError(&success);
+
+    framebufferEvent();
+
+    if(config->debuggingEnabled)config->logMessage("[%f] generated all framebuffer objects \n", glfwGetTime());
+    checkGLError(&success);
+}
+
+bool Renderer::run(core::FrameConfig *frameConfig){
+    PROFILE_ZONE("Renderer::run");
+
+    debug.frame++;
+    debug.gpu_start_ms = glfwGetTime() * 1000.0;
+    debug.start_ms = debug.end_ms;
+    debug.end_ms = glfwGetTime() * 1000.0;
+
+    debug.scene_capacity = volume->capacity * (sizeof(Octree::Node) + sizeof(Octree::Attribute) + sizeof(uint8_t));
+    debug.scene_mem = volume->size * (sizeof(Octree::Node) + sizeof(Octree::Attribute) + sizeof(uint8_t));
+    debug.lBuffer_mem = lBuffer.size.x * lBuffer.size.y * sizeof(GLuint);
+    debug.lBuffer_capacity = lBuffer.capacity;
+
+    debug.voxels_num = volume->numVoxels;
+    bool statsStale = volume->revision != debug.octree_stats.revision && glfwGetTime() - octreeStatsAt >= OCTREE_STATS_SECONDS;
+    if(frameConfig->countOctree || (frameConfig->octreeStats && statsStale)){
+        debug.octree_stats = volume->computeStats(jobs);
+        octreeStatsAt = glfwGetTime();
+        frameConfig->countOctree = false;
+        if(config->debuggingEnabled)config->logMessage("[%f] counted the octree in %f ms, %.1f%% fragmented \n", glfwGetTime(), debug.octree_stats.ms, debug.octree_stats.fragmentation * 100.0f);
+    }
+    debug.cam_position = camera->position;
+    debug.cam_direction = camera->direction;
+
+    handleShaderRecompilation(frameConfig);
+
+    debug.gpu_shaderCompilation_ms = glfwGetTime() * 1000.0;
+
+    glm::ivec2 displayComparaison = rrm.displaySize;
+    rrm.displaySize = config->framebufferSize();
+
+    if(rrm.displaySize != displayComparaison){
+        framebufferEvent();
+        if(config->debuggingEnabled)config->logMessage("[%f] framebuffer resized \n", glfwGetTime());
+        checkGLError(&success);
+    }
+
+    debug.gpu_framebufferResize_ms = glfwGetTime() * 1000.0;
+
+    updateCompaction(frameConfig);
+
+    //entries stamped by the other clock would age arbitrarily, a replay starts from an empty table on its first swap
+    if((frameConfig->clock >= 0.0) != pathClock){
+        pathClock = frameConfig->clock >= 0.0;
+        clearLightingBuffer();
+        lBuffer.instruction = 1;
+        lBuffer.accumulationTime = pathClock ? frameConfig->clock : glfwGetTime();
+    }
+
+    //runs first so patched normals are part of the same occlusion bake
+    if(frameConfig->recomputeNormals){
+        PROFILE_ZONE("normal update");
+        uint32_t patched = normalBaker->update(volume);
+        debug.normal_tiles_pending = normalBaker->pending();
+        if(patched > 0){
+            debug.normal_leaves = patched;
+            if(config->debuggingEnabled)config->logMessage("[%f] recomputed %u normals, %u tiles pending \n", glfwGetTime(), patched, debug.normal_tiles_pending);
+        }
+    }else{
+        //edits made meanwhile keep the normals they were inserted with
+        std::vector<Octree::Region> skipped;
+        volume->consumeDirtyRegions(skipped);
+    }
+
+    if(frameConfig->bakeOcclusion){
+        PROFILE_ZONE("occlusion bake");
+        double bakeStart = glfwGetTime();
+        uint32_t baked = occlusionBaker->update(volume);
+        if(baked > 0){
+            debug.cpu_occlusion_ms = (glfwGetTime() - bakeStart) * 1000.0;
+            debug.occlusion_leaves = baked;
+            if(config->debuggingEnabled)config->logMessage("[%f] baked ambient occlusion of %u leaves \n", glfwGetTime(), baked);
+        }
+    }
+
+    if(frameConfig->replayVoxelStream){
+        replayVoxelStream();
+        frameConfig->replayVoxelStream = false;
+    }
+
+    if(frameConfig->ropes != volume->hasRopes()){
+        volume->setRopes(frameConfig->ropes);
+        if(config->debuggingEnabled)config->logMessage("[%f] octree ropes %s \n", glfwGetTime(), frameConfig->ropes ? "built" : "dropped");
+    }
+    volume->FlushAttributes();
+    coneTracingTrack(frameConfig->renderType == core::RenderType::CONETRACING);
+    instances->Upload();
+    materialPool->Upload();
+
+    capture->poll();
+
+    bool reset = progressiveReset(frameConfig);
+    bool trace = !(frameConfig->progressive && pBuffer.converged) || reset;
+
+    graph.begin();
+    RenderGraph::Resource lighting = graph.import("lBuffer", lBuffer.texture);
+    RenderGraph::Resource lightingStats = graph.import("lBuffer stats", lBuffer.stats.buffer, true);
+    RenderGraph::Resource lightingOccupancy = graph.import("lBuffer occupancy", lBuffer.occupancy.buffer, true);
+    RenderGraph::Resource traversal = graph.import("traversal stats", traversalStats.buffer, true);
+    RenderGraph::Resource convergedPixels = graph.import("converged pixels", pBuffer.counters.buffer, true);
+    RenderGraph::Resource radiance = graph.import("radiance", cBuffer.radianceBuffer, true);
+
+    //radiance in half floats, the voxel id in its own integer attachment so it stays exact past 2^24 nodes
+    RenderGraph::Resource beam = graph.transient("beam", {.format = GL_R32F, .divisor = BEAM_TILE, .filter = GL_NEAREST});
+    RenderGraph::Resource color = graph.transient("color", {.format = GL_RGBA16F, .divisor = 1, .filter = GL_LINEAR});
+    RenderGraph::Resource voxelId = graph.transient("voxel id", {.format = GL_R32UI, .divisor = 1, .filter = GL_NEAREST});
+    //already written by accumPass when fused
+    RenderGraph::Resource average = graph.transient("average", {.format = GL_RGBA16F, .divisor = 1, .filter = GL_LINEAR});
+
+    //the pass bodies only run in graph.execute(), everything they capture has to live until then
+    bool countStats = false, countConvergence = false;
+    bool coneTracing = frameConfig->renderType == core::RenderType::CONETRACING;
+
+    if(trace){
+        //frame uniforms, the counters have to be armed before the block is written
+
+        readLightingStats();
+        readTraversalStats();
+        //both counter sets are armed by the same countStats flag
+        countStats = traversalStats.fence == 0 && beginCounting(&lBuffer.stats);
+        if(countStats){
+            beginCounting(&traversalStats);
+            traversalRoped = volume->hasRopes();
+        }
+        if(frameConfig->progressive){
+            progressiveReadback(frameConfig);
+            countConvergence = beginCounting(&pBuffer.counters);
+        }
+        updateFrameUniforms(frameConfig, countStats, countConvergence);
+
+        //beamPass
+
+        readTimer(&beamTimer, &debug.gpu_beam_query_ms, &debug.gpu_beam_query_frame);
+        if(frameConfig->beamPrepass){
+            graph.pass("beamPass", [&](){
+                glUseProgram(beamPass.program);
+                glBindImageTexture(0, graph.texture(beam), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+                {
+                    uint8_t texturesBound = 0;
+                    volume->BindUniforms(texturesBound, beamPass.uniforms);
+                }
+                bool timeBeam = beginTimer(&beamTimer);
+                glDispatchCompute((GLuint)ceil((float)beamPass.globalSize.x / (float)beamPass.groupSize.x), (GLuint)ceil((float)beamPass.globalSize.y / (float)beamPass.groupSize.y), 1);
+                if(timeBeam)
+                    endTimer(&beamTimer);
+
+                if(config->debuggingEnabled)config->logMessage("[%f] beam pass \n", glfwGetTime());
+                checkGLError(&success);
+            }).use(beam, RenderGraph::IMAGE_WRITE);
+        }else{
+            debug.gpu_beam_query_ms = 0;
+        }
+
+        //conePass, radiance of the hierarchy read by the cone tracing ray shader
+
+        readTimer(&coneTimer, &debug.gpu_cone_query_ms, &debug.gpu_cone_query_frame);
+        if(coneTracing){
+            graph.pass("conePass", [&](){
+                coneTracingUpdate(frameConfig);
+            }).use(radiance, RenderGraph::STORAGE_WRITE);
+        }else{
+            debug.gpu_cone_query_ms = 0;
+        }
+
+        //rayPass
+
+        if(readTimer(&rayTimer, &debug.gpu_ray_query_ms, &debug.gpu_ray_query_frame))
+            rayAverageMs = rayAverageMs == 0.0 ? debug.gpu_ray_query_ms : rayAverageMs * 0.95 + debug.gpu_ray_query_ms * 0.05;
+        RenderGraph::Pass &ray = graph.pass("rayPass", [&](){
+            // Set the viewport
+            glViewport(0, 0, rrm.framebufferSize.x, rrm.framebufferSize.y);
+            {
+                const GLfloat clearColor[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+                const GLuint clearId[4] = {0, 0, 0, 0};
+                glClearBufferfv(GL_COLOR, 0, clearColor);
+                glClearBufferuiv(GL_COLOR, 1, clearId);
+            }
+
+            glUseProgram(rayPass.program);
+
+            {
+                rrm.texturesBound = 0;
+                volume->BindUniforms(rrm.texturesBound, rayPass.uniforms);
+                instances->BindUniforms(rrm.texturesBound, rayPass.uniforms);
+
+                glActiveTexture(GL_TEXTURE0 + rrm.texturesBound);
+                glBindTexture(GL_TEXTURE_2D, frameConfig->beamPrepass ? graph.texture(beam) : 0);
+                glUniform1i(rayPass.uniforms.location[core::BEAM_TEXTURE], (int)rrm.texturesBound);
+                rrm.texturesBound++;
+
+                if(coneTracing)
+                    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, cBuffer.radianceBuffer);
+                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, traversalStats.buffer);
+            }
+
+            glBindVertexArray(rayPass.VAO);
+            bool timeRay = beginTimer(&rayTimer);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            if(timeRay)
+                endTimer(&rayTimer);
+
+            debug.gpu_pass1_ms = glfwGetTime() * 1000.0;
+            if(config->debuggingEnabled)config->logMessage("[%f] pass 1 \n", glfwGetTime());
+            checkGLError(&success);
+        });
+        ray.attach(color).attach(voxelId);
+        if(frameConfig->beamPrepass)
+            ray.use(beam, RenderGraph::SAMPLED);
+        if(coneTracing)
+            ray.use(radiance, RenderGraph::STORAGE_READ);
+        if(countStats){
+            ray.use(traversal, RenderGraph::STORAGE_WRITE);
+            graph.pass("traversal stats", [&](){
+                endCounting(&traversalStats);
+            }).use(traversal, RenderGraph::READBACK);
+        }
+
+        //accumPass
+
+        readTimer(&accumTimer, &debug.gpu_accum_query_ms, &debug.gpu_accum_query_frame);
+        readTimer(&avgTimer, &debug.gpu_avg_query_ms, &debug.gpu_avg_query_frame);
+        if(frameConfig->fuseAverage)
+            debug.gpu_avg_query_ms = 0;
+
+        RenderGraph::Pass &accum = graph.pass("accumPass", [&](){
+            glUseProgram(accumPass.program);
+            glBindImageTexture(0, graph.texture(color), 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
+            glBindImageTexture(1, lBuffer.texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+            glBindImageTexture(2, graph.texture(average), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+            glBindImageTexture(3, graph.texture(voxelId), 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32UI);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, lBuffer.stats.buffer);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, lBuffer.occupancy.buffer);
+
+            bool timeAccum = beginTimer(&accumTimer);
+            glDispatchCompute((GLuint)ceil((float)accumPass.globalSize.x / (float)accumPass.groupSize.x), (GLuint)ceil((float)accumPass.globalSize.y / (float)accumPass.groupSize.y), 1);
+            if(timeAccum)
+                endTimer(&accumTimer);
+
+            debug.gpu_pass2_ms = debug.gpu_pass3_ms = glfwGetTime() * 1000.0;
+            if(config->debuggingEnabled)config->logMessage("[%f] pass 2 \n", glfwGetTime());
+            checkGLError(&success);
+        });
+        accum.use(color, RenderGraph::IMAGE_READ).use(voxelId, RenderGraph::IMAGE_READ).use(lighting, RenderGraph::IMAGE_WRITE).use(lightingOccupancy, RenderGraph::STORAGE_WRITE);
+        if(frameConfig->fuseAverage)
+            accum.use(average, RenderGraph::IMAGE_WRITE);
+        if(countStats)
+            accum.use(lightingStats, RenderGraph::STORAGE_WRITE);
+
+        //the running count is only read, a new readback starts once the last one came back
+        if(lBuffer.occupancy.fence == 0){
+            graph.pass("lBuffer occupancy", [&](){
+                endCounting(&lBuffer.occupancy);
+            }).use(lightingOccupancy, RenderGraph::READBACK);
+        }
+
+        if(countStats){
+            graph.pass("lBuffer stats", [&](){
+                endCounting(&lBuffer.stats);
+            }).use(lightingStats, RenderGraph::READBACK);
+        }
+
+        //avgPass
+
+        if(!frameConfig->fuseAverage){
+            graph.pass("avgPass", [&](){
+                glUseProgram(avgPass.program);
+                glBindImageTexture(0, lBuffer.texture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32UI);
+                glBindImageTexture(1, graph.texture(color), 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
+                glBindImageTexture(2, graph.texture(average), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+                glBindImageTexture(3, graph.texture(voxelId), 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32UI);
+
+                bool timeAvg = beginTimer(&avgTimer);
+                glDispatchCompute((GLuint)ceil((float)avgPass.globalSize.x / (float)avgPass.groupSize.x), (GLuint)ceil((float)avgPass.globalSize.y / (float)avgPass.groupSize.y), 1);
+                if(timeAvg)
+                    endTimer(&avgTimer);
+
+                debug.gpu_pass3_ms = glfwGetTime() * 1000.0;
+                if(config->debuggingEnabled)config->logMessage("[%f] pass 3 \n", glfwGetTime());
+                checkGLError(&success);
+            }).use(lighting, RenderGraph::IMAGE_READ).use(color, RenderGraph::IMAGE_READ).use(voxelId, RenderGraph::IMAGE_READ).use(average, RenderGraph::IMAGE_WRITE);
+        }
+
+        if(frameConfig->recordVoxelStream){
+            graph.pass("voxel stream", [&](){
+                recordVoxelStream(graph.texture(voxelId));
+            }).use(voxelId, RenderGraph::READBACK);
+            frameConfig->recordVoxelStream = false;
+        }
+
+        //progPass
+
+        if(frameConfig->progressive){
+            RenderGraph::Pass &prog = graph.pass("progPass", [&](){
+                glUseProgram(progPass.program);
+                glBindImageTexture(0, graph.texture(average), 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
+                glBindImageTexture(1, graph.texture(meanTexture), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+                glBindImageTexture(2, graph.texture(varianceTexture), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+                glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, pBuffer.counters.buffer);
+                glDispatchCompute((GLuint)ceil((float)progPass.globalSize.x / (float)progPass.groupSize.x), (GLuint)ceil((float)progPass.globalSize.y / (float)progPass.groupSize.y), 1);
+                pBuffer.samples++;
+
+                if(config->debuggingEnabled)config->logMessage("[%f] progressive pass \n", glfwGetTime());
+                checkGLError(&success);
+            });
+            prog.use(average, RenderGraph::IMAGE_READ).use(meanTexture, RenderGraph::IMAGE_WRITE).use(varianceTexture, RenderGraph::IMAGE_WRITE);
+            if(countConvergence)
+                prog.use(convergedPixels, RenderGraph::COUNTER);
+
+            if(countConvergence){
+                graph.pass("convergence count", [&](){
+                    endCounting(&pBuffer.counters);
+                    pBuffer.countedGeneration = pBuffer.generation;
+                    pBuffer.countedSamples = pBuffer.samples;
+                }).use(convergedPixels, RenderGraph::READBACK);
+            }
+        }
+    }else{
+        debug.gpu_pass1_ms = debug.gpu_pass2_ms = debug.gpu_pass3_ms = debug.gpu_framebufferResize_ms;
+    }
+
+    //finalPass
+
+    RenderGraph::Pass &output = graph.pass("finalPass", [&](){
+        debug.gpu_progressive_ms = glfwGetTime() * 1000.0;
+
+        // Set the viewport
+        glViewport(rrm.framebufferPos.x, rrm.framebufferPos.y, rrm.framebufferSize.x, rrm.framebufferSize.y);
+
+        if(!frameConfig->renderToTexture)
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDisable(GL_DEPTH_TEST); // disable depth test so screen-space quad isn't discarded due to depth test.
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glUseProgram(finalPass.program);
+
+        glBindVertexArray(finalPass.VAO);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, graph.texture(frameConfig->progressive ? meanTexture : average));    // use the color attachment texture as the texture of the quad plane
+        glUniform1i(finalPass.uniforms.location[core::SCREEN_TEXTURE], 0);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+
+        // Unbind the textures after drawing
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    });
+    output.use(frameConfig->progressive ? meanTexture : average, RenderGraph::SAMPLED);
+    if(frameConfig->renderToTexture)
+        output.attach(finalTexture);
+
+    //capture, queues the copy of the image finalPass produced, picked up by a later frame
+    if(capture->wanted()){
+        RenderGraph::Pass &read = graph.pass("capture", [&](){
+            capture->read(frameConfig->renderToTexture ? graph.texture(finalTexture) : 0, rrm.framebufferPos, rrm.framebufferSize);
+        });
+        if(frameConfig->renderToTexture)
+            read.use(finalTexture, RenderGraph::READBACK);
+    }
+
+    graph.execute();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    debug.progressive_samples = pBuffer.samples;
+    debug.progressive_convergence = pBuffer.convergence;
+    debug.converged = frameConfig->progressive && pBuffer.converged;
+
+    debug.gBuffer_mem = graph.stats.transientBytes + graph.stats.persistentBytes;
+    debug.gBuffer_mem_unaliased = graph.stats.unaliasedBytes + graph.stats.persistentBytes;
+    debug.graph_passes = graph.stats.passes;
+    debug.graph_culled = graph.stats.culled;
+    debug.graph_barriers = graph.stats.barriers;
+    debug.graph_barriers_blanket = graph.stats.blanketBarriers;
+    debug.capture_frames = capture->stats.frames;
+    debug.capture_dropped = capture->stats.dropped;
+    debug.capture_busy = capture->stats.busy;
+
+    debug.gpu_end_ms = glfwGetTime() * 1000.0;
+    if(config->debuggingEnabled)config->logMessage("[%f] frame end \n", glfwGetTime());
+    checkGLError(&success);
+
+    return success; 
+}
+
+Renderer::~Renderer(){
+    camera->freeVRAM();
+    volume->freeVRAM();
+    materialPool->freeVRAM();
+
+    glDeleteVertexArrays(1, &finalPass.VAO);
+    glDeleteBuffers(1, &finalPass.VBO);
+
+    glDeleteVertexArrays(1, &rayPass.VAO);
+    glDeleteBuffers(1, &rayPass.VBO);
+    glDeleteTextures(1, &lBuffer.texture);
+    freeCounters(&pBuffer.counters);
+    freeCounters(&lBuffer.stats);
+    freeCounters(&lBuffer.occupancy);
+    freeCounters(&traversalStats);
+    glDeleteQueries(1, &accumTimer.query);
+    glDeleteQueries(1, &avgTimer.query);
+    glDeleteQueries(1, &beamTimer.query);
+    glDeleteQueries(1, &coneTimer.query);
+    glDeleteQueries(1, &rayTimer.query);
+    glDeleteBuffers(1, &cBuffer.radianceBuffer);
+    glDeleteBuffers(1, &cBuffer.leafBuffer);
+    glDeleteBuffers(1, &cBuffer.nodeBuffer);
+    glDeleteBuffers(1, &frameUBO);
+    delete lModel;
+    delete occlusionBaker;
+    delete normalBaker;
+    if(compactJob)
+        jobs->wait(compactJob);
+    delete capture;
+    delete reloader;
+
+    glDeleteProgram(rayPass.program);
+    glDeleteProgram(accumPass.program);
+    glDeleteProgram(avgPass.program);
+    glDeleteProgram(progPass.program);
+    glDeleteProgram(beamPass.program);
+    glDeleteProgram(injectPass.program);
+    glDeleteProgram(filterPass.program);
+    glDeleteProgram(finalPass.program);
+}
+
+float* Renderer::genQuad(glm::vec2 size, glm::vec2 tex){
+    float *quadVertices = new float[24]{
+        -size.x,  size.y,  0.0f, tex.y,
+        -size.x, -size.y,  0.0f,  0.0f,
+         size.x, -size.y,  tex.x, 0.0f,
+
+        -size.x,  size.y,  0.0f,  tex.y,
+         size.x, -size.y,  tex.x, 0.0f,
+         size.x,  size.y,  tex.x, tex.y
+    };
+    return quadVertices;
+}
+
+void Renderer::framebufferEvent(){
+
+    // Calculate the aspect ratio of the window
+    float windowAspect = (float)rrm.displaySize.x / (float)rrm.displaySize.y;
+
+    if (windowAspect > config->aspectRatio) {
+        // Window is wider than desired aspect ratio
+        rrm.framebufferSize.y = rrm.displaySize.y;
+        rrm.framebufferSize.x = static_cast<int>(rrm.displaySize.y * config->aspectRatio);
+        rrm.framebufferPos.x = (rrm.displaySize.x - rrm.framebufferSize.x) / 2;
+        rrm.framebufferPos.y = 0;
+    } else {
+        // Window is taller than desired aspect ratio
+        rrm.framebufferSize.x = rrm.displaySize.x;
+        rrm.framebufferSize.y = static_cast<int>(rrm.displaySize.x / config->aspectRatio);
+        rrm.framebufferPos.x = 0;
+        rrm.framebufferPos.y = (rrm.displaySize.y - rrm.framebufferSize.y) / 2;
+    }
+
+    accumPass.globalSize = glm::ivec2(rrm.framebufferSize.x, rrm.framebufferSize.y);
+    accumPass.groupSize = glm::ivec2(8, 8);
+    avgPass.globalSize = glm::ivec2(rrm.framebufferSize.x, rrm.framebufferSize.y);
+    avgPass.groupSize = glm::ivec2(8, 8);
+    progPass.globalSize = glm::ivec2(rrm.framebufferSize.x, rrm.framebufferSize.y);
+    progPass.groupSize = glm::ivec2(8, 8);
+    beamPass.globalSize = (rrm.framebufferSize + BEAM_TILE - 1) / BEAM_TILE;
+    beamPass.groupSize = glm::ivec2(8, 8);
+
+    //every graph owned texture follows the framebuffer size
+    graph.resize(rrm.framebufferSize);
+
+    pBuffer.samples = 0;
+
+    //same framebuffer size with the previous all RGBA32F + depth layout, the graph reports the current one
+    uint32_t pixels = rrm.framebufferSize.x * rrm.framebufferSize.y;
+    debug.gBuffer_mem_rgba32f = pixels * (16 + 4 + 16 + 16 + 4 + 16 + 16);
+}
+
+bool Renderer::progressiveReset(core::FrameConfig *frameConfig){
+    bool changed = volume->modified || materialPool->modified || instances->modified ||
+        rrm.cameraPosition != camera->position ||
+        rrm.cameraDirection != camera->direction ||
+        rrm.cameraFOV != *camera->FOV ||
+        rrm.renderType != frameConfig->renderType ||
+        rrm.spp != frameConfig->spp ||
+        rrm.bounces != frameConfig->bounces ||
+        rrm.controlchecks != frameConfig->controlchecks ||
+        rrm.progressive != frameConfig->progressive ||
+        rrm.lodBias != frameConfig->lodBias ||
+        rrm.ambient != frameConfig->ambient;
+
+    volume->modified = false;
+    materialPool->modified = false;
+    instances->modified = false;
+    rrm.cameraPosition = camera->position;
+    rrm.cameraDirection = camera->direction;
+    rrm.cameraFOV = *camera->FOV;
+    rrm.renderType = frameConfig->renderType;
+    rrm.spp = frameConfig->spp;
+    rrm.bounces = frameConfig->bounces;
+    rrm.controlchecks = frameConfig->controlchecks;
+    rrm.progressive = frameConfig->progressive;
+    rrm.lodBias = frameConfig->lodBias;
+    rrm.ambient = frameConfig->ambient;
+
+    if(changed)
+        pBuffer.samples = 0;
+
+    if(pBuffer.samples == 0){
+        //invalidates any convergence count still in flight
+        pBuffer.generation++;
+        pBuffer.converged = false;
+        pBuffer.convergence = 0;
+        return true;
+    }
+    return false;
+}
+
+void Renderer::progressiveReadback(core::FrameConfig *frameConfig){
+    GLuint convergedPixels = 0;
+    if(!readCounters(&pBuffer.counters, &convergedPixels))
+        return;
+
+    if(pBuffer.countedGeneration != pBuffer.generation)
+        return;
+
+    pBuffer.convergence = (float)convergedPixels / (float)(rrm.framebufferSize.x * rrm.framebufferSize.y);
+    pBuffer.converged = pBuffer.countedSamples >= (uint32_t)frameConfig->minSamples && pBuffer.convergence >= frameConfig->convergedRatio;
+}
+
+void Renderer::readLightingStats(){
+    GLuint occupied;
+    if(readCounters(&lBuffer.occupancy, &occupied)){
+        lBuffer.occupied = std::min(occupied, lBuffer.capacity);
+        debug.lBuffer_occupied = lBuffer.occupied;
+    }
+
+    GLuint values[5];
+    if(!readCounters(&lBuffer.stats, values))
+        return;
+
+    debug.lBuffer_lookups = values[0];
+    debug.lBuffer_claims = values[1];
+    debug.lBuffer_probes = values[2];
+    debug.lBuffer_evictions = values[3];
+    debug.lBuffer_failures = values[4];
+}
+
+void Renderer::readTraversalStats(){
+    GLuint values[2];
+    if(!readCounters(&traversalStats, values))
+        return;
+
+    debug.traversal_rays = values[0];
+    debug.traversal_fetches = values[1];
+    debug.traversal_ropes = traversalRoped;
+}
+
+void Renderer::updateFrameUniforms(core::FrameConfig *frameConfig, bool countStats, bool countConvergence){
+    frameUniforms.screenResolution = rrm.framebufferSize;
+    //benchmarks run the seed and the lighting buffer on path time, so replays trace the same samples
+    double now = pathClock ? frameConfig->clock : glfwGetTime();
+    frameUniforms.time = (int)(now*10000);
+    frameUniforms.lightingTime = (GLuint)(now*100);
+    frameUniforms.spp = frameConfig->spp;
+    frameUniforms.lightBounces = frameConfig->bounces;
+    frameUniforms.controlchecks = (GLuint)frameConfig->controlchecks;
+    frameUniforms.lodBias = frameConfig->lodBias;
+    frameUniforms.ambient = frameConfig->ambient;
+    frameUniforms.coneSteps = (GLuint)frameConfig->coneSteps;
+    frameUniforms.beamTileSize = frameConfig->beamPrepass ? BEAM_TILE : 0;
+
+    frameUniforms.instruction = lBuffer.instruction;
+    if(now - lBuffer.accumulationTime > frameConfig->lBufferSwapSeconds && !(frameConfig->TAA)){
+        lBuffer.accumulationTime = now;
+        switch(lBuffer.instruction){
+            case ADDRIGHT:
+                frameUniforms.instruction = ADDCLEARLEFT;
+                lBuffer.instruction = ADDLEFT;
+                break;
+            case ADDLEFT:
+                frameUniforms.instruction = ADDCLEARRIGHT;
+                lBuffer.instruction = ADDRIGHT;
+                break;
+        }
+    }
+    frameUniforms.updateTime = (GLuint)(2.0 * (debug.end_ms - debug.start_ms));
+    frameUniforms.countStats = (int)countStats;
+    frameUniforms.fuseAverage = (int)frameConfig->fuseAverage;
+
+    frameUniforms.reset = (int)(pBuffer.samples == 0);
+    frameUniforms.countConvergence = (int)countConvergence;
+    frameUniforms.minSamples = frameConfig->minSamples;
+    frameUniforms.threshold = frameConfig->convergenceThreshold;
+
+    //orphaned like the camera block, so the previous frame's passes never stall the upload
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(core::FrameUniforms), &frameUniforms, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void Renderer::recordVoxelStream(GLuint idTexture){
+    //debug capture, a blocking readback is fine here
+    std::vector<uint32_t> ids(rrm.framebufferSize.x * rrm.framebufferSize.y);
+    glBindTexture(GL_TEXTURE_2D, idTexture);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, ids.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    std::vector<uint32_t> keys;
+    keys.reserve(ids.size());
+    for(uint32_t id : ids)
+        if(id != 0)
+            keys.push_back(id);
+
+    LightingHashTable::appendStream(LBUFFER_STREAM, keys);
+
+    lModel->simulate(keys, (uint32_t)(glfwGetTime()*100));
+    config->logMessage("[%f] lBuffer model: %zu keys \n", glfwGetTime(), keys.size());
+    reportModel(*lModel);
+}
+
+//every recorded frame runs through a fresh model of the live table, one after the other
+void Renderer::replayVoxelStream(){
+    std::vector<std::vector<uint32_t>> frames;
+    if(!LightingHashTable::loadStream(LBUFFER_STREAM, frames) || frames.empty()){
+        config->logMessage("[%f] no voxel id stream to replay at %s \n", glfwGetTime(), LBUFFER_STREAM);
+        return;
+    }
+
+    LightingHashTable model(lModel->config);
+    uint32_t time = 0;
+    for(const std::vector<uint32_t> &keys : frames){
+        time += LBUFFER_REPLAY_TICKS;
+        model.simulate(keys, time);
+    }
+    config->logMessage("[%f] lBuffer model replayed %zu frames of %s \n", glfwGetTime(), frames.size(), LBUFFER_STREAM);
+    reportModel(model);
+}
+
+void Renderer::reportModel(const LightingHashTable &model){
+    const LightingHashTable::Stats &stats = model.stats;
+    std::string histogram;
+    debug.lBuffer_model_probes.clear();
+    for(uint64_t count : stats.probeHistogram){
+        histogram += " " + std::to_string(count);
+        debug.lBuffer_model_probes.push_back((float)count);
+    }
+    debug.lBuffer_model_load = stats.loadFactor(model.capacity);
+    debug.lBuffer_model_evictions = stats.evictionRate();
+    debug.lBuffer_model_failures = stats.failureRate();
+
+    config->logMessage("[%f] lBuffer model: load %.3f, avg probe %.2f, evictions %.4f, failures %.4f \n", glfwGetTime(),
+        debug.lBuffer_model_load, stats.averageProbe(), debug.lBuffer_model_evictions, debug.lBuffer_model_failures);
+    config->logMessage("[%f] lBuffer model lookups by probe length:%s \n", glfwGetTime(), histogram.c_str());
+}
+
+void Renderer::clearLightingBuffer(){
+    GLuint zero = 0;
+    glClearTexImage(lBuffer.texture, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    //counts still in flight describe the old table
+    discardCounters(&lBuffer.stats);
+    discardCounters(&lBuffer.occupancy);
+    beginCounting(&lBuffer.occupancy);
+    lBuffer.occupied = 0;
+    debug.lBuffer_occupied = 0;
+}
+
+//the copy is built on a worker, installing it swaps the arrays and re-uploads them on this thread
+void Renderer::updateCompaction(core::FrameConfig *frameConfig){
+    if(compactJob && jobs->finished(compactJob)){
+        compactJob = nullptr;
+        uint32_t slots = volume->size, allocated = volume->capacity;
+        if(volume->install(*compaction)){
+            //lighting entries are keyed by node index
+            clearLightingBuffer();
+            debug.compact_ray_before_ms = rayAverageMs;
+            debug.compact_ray_after_ms = 0;
+            compactedFrames = 0;
+            if(config->debuggingEnabled)config->logMessage("[%f] octree compacted %s, %u -> %u slots, capacity %u -> %u \n", glfwGetTime(),
+                compaction->order == Octree::DEPTH_FIRST ? "depth first" : "breadth first", slots, volume->size, allocated, volume->capacity);
+        }else{
+            //edited while copying, the next frame starts over
+            frameConfig->compactOctree = true;
+            if(config->debuggingEnabled)config->logMessage("[%f] octree edited during compaction, retrying \n", glfwGetTime());
+        }
+        compaction = nullptr;
+    }
+
+    if(frameConfig->compactOctree && !compactJob){
+        frameConfig->compactOctree = false;
+        Octree::Order order = frameConfig->compactDepthFirst ? Octree::DEPTH_FIRST : Octree::BREADTH_FIRST;
+        compaction = nullptr;
+        compactJob = jobs->run([this, order](){
+            compaction = volume->compact(order);
+        });
+    }
+
+    //the average needs a while to forget the old layout
+    if(debug.compact_ray_before_ms > 0 && debug.compact_ray_after_ms == 0 && ++compactedFrames == COMPACT_SETTLE_FRAMES){
+        debug.compact_ray_after_ms = rayAverageMs;
+        config->logMessage("[%f] ray pass %f ms before compaction, %f ms after \n", glfwGetTime(), debug.compact_ray_before_ms, debug.compact_ray_after_ms);
+    }
+}
+
+namespace{
+    void markDirty(glm::uvec2 &dirty, uint32_t at){
+        dirty.x = std::min(dirty.x, at);
+        dirty.y = std::max(dirty.y, at + 1);
+    }
+}
+
+//slot edits are drained every frame, outside cone tracing they only leave the lists stale
+void Renderer::coneTracingTrack(bool coneTracing){
+    volume->consumeSlotEdits(coneEdits);
+    if(!coneTracing){
+        cBuffer.revision = UINT32_MAX;
+        return;
+    }
+    //node indices changed (install) or nobody kept the lists up to date
+    if(cBuffer.revision != volume->layoutRevision || cBuffer.capacity > volume->capacity){
+        coneTracingRebuild();
+        return;
+    }
+    if(cBuffer.capacity != volume->capacity)
+        coneTracingGrow();
+    if(!coneEdits.empty())
+        coneTracingPatch(coneEdits);
+}
+
+//the whole hierarchy again with all radiance cleared, only after every node index changed or the lists went stale
+void Renderer::coneTracingRebuild(){
+    PROFILE_ZONE("Renderer::coneTracingRebuild");
+    volume->hierarchy(cBuffer.levelLists, cBuffer.leafList);
+
+    cBuffer.listedIn.assign(volume->capacity, 0);
+    cBuffer.listedAt.assign(volume->capacity, 0);
+    for(uint32_t i = 0; i < cBuffer.leafList.size(); i++){
+        cBuffer.listedIn[cBuffer.leafList[i].x] = 1;
+        cBuffer.listedAt[cBuffer.leafList[i].x] = i;
+    }
+    for(size_t level = 0; level < cBuffer.levelLists.size(); level++){
+        for(uint32_t i = 0; i < cBuffer.levelLists[level].size(); i++){
+            cBuffer.listedIn[cBuffer.levelLists[level][i]] = (uint8_t)(2 + level);
+            cBuffer.listedAt[cBuffer.levelLists[level][i]] = i;
+        }
+    }
+
+    //no reserved space yet, both lists are laid out and uploaded whole
+    cBuffer.leafCapacity = 0;
+    cBuffer.levelCapacities.clear();
+    coneTracingUpload();
+
+    //empty space has to read as transparent, lit values of removed voxels would otherwise linger
+    cBuffer.capacity = volume->capacity;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cBuffer.radianceBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, cBuffer.capacity * sizeof(glm::vec4), NULL, GL_DYNAMIC_COPY);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_RGBA32F, GL_RGBA, GL_FLOAT, NULL);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    cBuffer.revision = volume->layoutRevision;
+    cBuffer.injectOffset = 0;
+
+    if(config->debuggingEnabled)config->logMessage("[%f] cone tracing hierarchy rebuilt, %u leaves \n", glfwGetTime(), cBuffer.leaves);
+    checkGLError(&success);
+}
+
+//capacity grew without moving any node, the radiance so far is kept and the new slots start transparent
+void Renderer::coneTracingGrow(){
+    uint32_t previous = cBuffer.capacity;
+    cBuffer.capacity = volume->capacity;
+    cBuffer.listedIn.resize(cBuffer.capacity, 0);
+    cBuffer.listedAt.resize(cBuffer.capacity, 0);
+
+    GLuint copy;
+    glGenBuffers(1, &copy);
+    glBindBuffer(GL_COPY_READ_BUFFER, cBuffer.radianceBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, copy);
+    glBufferData(GL_COPY_WRITE_BUFFER, previous * sizeof(glm::vec4), NULL, GL_STATIC_COPY);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, previous * sizeof(glm::vec4));
+
+    glBindBuffer(GL_COPY_READ_BUFFER, copy);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, cBuffer.radianceBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, cBuffer.capacity * sizeof(glm::vec4), NULL, GL_DYNAMIC_COPY);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, previous * sizeof(glm::vec4));
+    glClearBufferSubData(GL_COPY_WRITE_BUFFER, GL_RGBA32F, previous * sizeof(glm::vec4), (cBuffer.capacity - previous) * sizeof(glm::vec4), GL_RGBA, GL_FLOAT, NULL);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &copy);
+}
+
+//moves every edited slot to the list matching its state now, only its last edit says where the slot sits since
+//a freed block can be reused at another depth within the same frame
+void Renderer::coneTracingPatch(const std::vector<Octree::SlotEdit> &edits){
+    PROFILE_ZONE("Renderer::coneTracingPatch");
+    std::vector<Octree::SlotEdit> latest(edits.rbegin(), edits.rend());
+    std::stable_sort(latest.begin(), latest.end(), [](const Octree::SlotEdit &a, const Octree::SlotEdit &b){ return a.index < b.index; });
+    latest.erase(std::unique(latest.begin(), latest.end(), [](const Octree::SlotEdit &a, const Octree::SlotEdit &b){ return a.index == b.index; }), latest.end());
+
+    std::vector<uint32_t> cleared;
+    for(const Octree::SlotEdit &edit : latest){
+        uint32_t slot = edit.index;
+        coneTracingUnlist(slot);
+        Octree::Node node = volume->data[slot];
+        if(node.base.isNode){
+            std::vector<uint32_t> &level = cBuffer.levelLists[edit.depth - 1];
+            cBuffer.listedIn[slot] = (uint8_t)(2 + edit.depth - 1);
+            cBuffer.listedAt[slot] = level.size();
+            markDirty(cBuffer.levelDirty[edit.depth - 1], level.size());
+            level.push_back(slot);
+            continue;
+        }
+        if(node.leaf.material != 0){
+            cBuffer.listedIn[slot] = 1;
+            cBuffer.listedAt[slot] = cBuffer.leafList.size();
+            markDirty(cBuffer.leafDirty, cBuffer.leafList.size());
+            cBuffer.leafList.push_back(glm::uvec4(slot, edit.position.x, edit.position.y, edit.position.z));
+        }
+        //a new leaf starts dark and an emptied one turns transparent, internal nodes are filtered again every frame anyway
+        cleared.push_back(slot);
+    }
+    coneTracingUpload();
+
+    //cleared is sorted already, neighbouring slots go out as one clear
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cBuffer.radianceBuffer);
+    for(size_t i = 0; i < cleared.size();){
+        size_t j = i + 1;
+        while(j < cleared.size() && cleared[j] == cleared[j - 1] + 1)
+            j++;
+        glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_RGBA32F, cleared[i] * sizeof(glm::vec4), (j - i) * sizeof(glm::vec4), GL_RGBA, GL_FLOAT, NULL);
+        i = j;
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+//swaps the last entry into the hole, so the lists stay dense
+void Renderer::coneTracingUnlist(uint32_t slot){
+    uint8_t list = cBuffer.listedIn[slot];
+    if(list == 0)
+        return;
+    uint32_t at = cBuffer.listedAt[slot];
+    cBuffer.listedIn[slot] = 0;
+    if(list == 1){
+        std::vector<glm::uvec4> &leaves = cBuffer.leafList;
+        leaves[at] = leaves.back();
+        leaves.pop_back();
+        if(at < leaves.size()){
+            cBuffer.listedAt[leaves[at].x] = at;
+            markDirty(cBuffer.leafDirty, at);
+        }
+    }else{
+        std::vector<uint32_t> &level = cBuffer.levelLists[list - 2];
+        level[at] = level.back();
+        level.pop_back();
+        if(at < level.size()){
+            cBuffer.listedAt[level[at]] = at;
+            markDirty(cBuffer.levelDirty[list - 2], at);
+        }
+    }
+}
+
+//uploads the patched ranges, a list outgrowing its reserved space is laid out again with slack and uploaded whole
+void Renderer::coneTracingUpload(){
+    std::vector<glm::uvec4> &leaves = cBuffer.leafList;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cBuffer.leafBuffer);
+    if(cBuffer.leafCapacity == 0 || leaves.size() > cBuffer.leafCapacity){
+        cBuffer.leafCapacity = std::max<uint32_t>(leaves.size() * 2, 1024);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, cBuffer.leafCapacity * sizeof(glm::uvec4), NULL, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, leaves.size() * sizeof(glm::uvec4), leaves.data());
+    }else{
+        uint32_t end = std::min<uint32_t>(cBuffer.leafDirty.y, leaves.size());
+        if(cBuffer.leafDirty.x < end)
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, cBuffer.leafDirty.x * sizeof(glm::uvec4), (end - cBuffer.leafDirty.x) * sizeof(glm::uvec4), &leaves[cBuffer.leafDirty.x]);
+    }
+    cBuffer.leafDirty = glm::uvec2(UINT32_MAX, 0);
+    cBuffer.leaves = leaves.size();
+
+    std::vector<std::vector<uint32_t>> &levels = cBuffer.levelLists;
+    bool relayout = cBuffer.levelCapacities.size() != levels.size();
+    for(size_t level = 0; level < levels.size() && !relayout; level++)
+        relayout = levels[level].size() > cBuffer.levelCapacities[level];
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cBuffer.nodeBuffer);
+    if(relayout){
+        uint32_t total = 0;
+        cBuffer.levelOffsets.clear();
+        cBuffer.levelCapacities.clear();
+        for(std::vector<uint32_t> &level : levels){
+            cBuffer.levelOffsets.push_back(total);
+            cBuffer.levelCapacities.push_back(std::max<uint32_t>(level.size() * 2, 64));
+            total += cBuffer.levelCapacities.back();
+        }
+        glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<uint32_t>(total, 1) * sizeof(uint32_t), NULL, GL_DYNAMIC_DRAW);
+        for(size_t level = 0; level < levels.size(); level++)
+            if(!levels[level].empty())
+                glBufferSubData(GL_SHADER_STORAGE_BUFFER, cBuffer.levelOffsets[level] * sizeof(uint32_t), levels[level].size() * sizeof(uint32_t), levels[level].data());
+    }else{
+        for(size_t level = 0; level < levels.size(); level++){
+            glm::uvec2 dirty = cBuffer.levelDirty[level];
+            uint32_t end = std::min<uint32_t>(dirty.y, levels[level].size());
+            if(dirty.x < end)
+                glBufferSubData(GL_SHADER_STORAGE_BUFFER, (cBuffer.levelOffsets[level] + dirty.x) * sizeof(uint32_t), (end - dirty.x) * sizeof(uint32_t), &levels[level][dirty.x]);
+        }
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    cBuffer.levelDirty.assign(levels.size(), glm::uvec2(UINT32_MAX, 0));
+    cBuffer.levelSizes.clear();
+    for(std::vector<uint32_t> &level : levels)
+        cBuffer.levelSizes.push_back(level.size());
+}
+
+void Renderer::coneTracingUpdate(core::FrameConfig *frameConfig){
+    PROFILE_ZONE("Renderer::coneTracingUpdate");
+    if(cBuffer.leaves == 0)
+        return;
+
+    bool timeCone = beginTimer(&coneTimer);
+
+    //injection, a round robin slice of the leaves gathers light from the current hierarchy
+    GLuint budget = (GLuint)std::min<uint32_t>(std::max(frameConfig->injectBudget, 1), cBuffer.leaves);
+    glUseProgram(injectPass.program);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, cBuffer.radianceBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, cBuffer.leafBuffer);
+    {
+        uint8_t texturesBound = 0;
+        volume->BindUniforms(texturesBound, injectPass.uniforms);
+
+        glUniform1ui(injectPass.uniforms.location[core::LEAF_COUNT], cBuffer.leaves);
+        glUniform1ui(injectPass.uniforms.location[core::LEAF_OFFSET], cBuffer.injectOffset);
+        glUniform1ui(injectPass.uniforms.location[core::BUDGET], budget);
+    }
+    glDispatchCompute((budget + 63) / 64, 1, 1);
+    cBuffer.injectOffset = (cBuffer.injectOffset + budget) % cBuffer.leaves;
+
+    //filtering, every level averages the level below it, the graph makes the last one visible to the ray pass
+    glUseProgram(filterPass.program);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, cBuffer.nodeBuffer);
+    {
+        uint8_t texturesBound = 0;
+        volume->BindUniforms(texturesBound, filterPass.uniforms);
+
+        GLint offsetLoc = filterPass.uniforms.location[core::LEVEL_OFFSET];
+        GLint sizeLoc = filterPass.uniforms.location[core::LEVEL_SIZE];
+        for(int level = (int)cBuffer.levelSizes.size() - 1; level >= 0; level--){
+            if(cBuffer.levelSizes[level] == 0)
+                continue;
+            glUniform1ui(offsetLoc, cBuffer.levelOffsets[level]);
+            glUniform1ui(sizeLoc, cBuffer.levelSizes[level]);
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+            glDispatchCompute((cBuffer.levelSizes[level] + 63) / 64, 1, 1);
+        }
+    }
+
+    if(timeCone)
+        endTimer(&coneTimer);
+
+    if(config->debuggingEnabled)config->logMessage("[%f] cone pass \n", glfwGetTime());
+    checkGLError(&success);
+}
+
+void Renderer::genCounters(core::gpuCounters *counters, uint32_t count){
+    counters->count = count;
+    counters->fence = 0;
+    glGenBuffers(1, &counters->buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, counters->buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, count * sizeof(GLuint), NULL, GL_DYNAMIC_READ);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+bool Renderer::beginCounting(core::gpuCounters *counters){
+    if(counters->fence)
+        return false;
+    std::vector<GLuint> zero(counters->count, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, counters->buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, counters->count * sizeof(GLuint), zero.data());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return true;
+}
+
+void Renderer::endCounting(core::gpuCounters *counters){
+    counters->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool Renderer::readCounters(core::gpuCounters *counters, GLuint *values){
+    if(!counters->fence)
+        return false;
+
+    //never block on the GPU, the values are picked up by a later frame once they are ready
+    GLenum status = glClientWaitSync(counters->fence, 0, 0);
+    if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        return false;
+
+    glDeleteSync(counters->fence);
+    counters->fence = 0;
+
+    glBindBuffer(GL_COPY_READ_BUFFER, counters->buffer);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, counters->count * sizeof(GLuint), values);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    return true;
+}
+
+//drops a readback in flight, its values are never read
+void Renderer::discardCounters(core::gpuCounters *counters){
+    if(counters->fence)glDeleteSync(counters->fence);
+    counters->fence = 0;
+}
+
+void Renderer::freeCounters(core::gpuCounters *counters){
+    glDeleteBuffers(1, &counters->buffer);
+    if(counters->fence)glDeleteSync(counters->fence);
+}
+
+bool Renderer::beginTimer(core::gpuTimer *timer){
+    if(timer->pending)
+        return false;
+    glBeginQuery(GL_TIME_ELAPSED, timer->query);
+    return true;
+}
+
+void Renderer::endTimer(core::gpuTimer *timer){
+    glEndQuery(GL_TIME_ELAPSED);
+    timer->pending = true;
+    timer->frame = debug.frame;
+}
+
+//results come back a frame or more late, frame tells which run() they measured
+bool Renderer::readTimer(core::gpuTimer *timer, double *ms, uint64_t *frame){
+    if(!timer->pending)
+        return false;
+
+    GLint available = 0;
+    glGetQueryObjectiv(timer->query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if(!available)
+        return false;
+
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(timer->query, GL_QUERY_RESULT, &elapsed);
+    timer->pending = false;
+    *ms = (double)elapsed / 1000000.0;
+    *frame = timer->frame;
+    return true;
+}
+
+void Renderer::handleShaderRecompilation(core::FrameConfig *frameConfig){
+    bool swapped = false;
+
+    if(currentRenderType != frameConfig->renderType){
+        const char *fragment = "./shd/ray.frag";
+        switch (frameConfig->renderType)
+        {
+        case core::RenderType::DEFAULT :
+            fragment = "./shd/ray.frag";
+            break;
+        case core::RenderType::NORMAL :
+            fragment = "./shd/normal_ray.frag";
+            break;
+        case core::RenderType::STRUCTURE :
+            fragment = "./shd/accel_struct_ray.frag";
+            break;     
+        case core::RenderType::ALBEDO :
+            fragment = "./shd/albedo_ray.frag";
+            break;    
+        case core::RenderType::VOXELID :
+            fragment = "./shd/voxelid_ray.frag";
+            break;    
+        case core::RenderType::CONETRACING :
+            fragment = "./shd/cone_ray.frag";
+            break;
+        }
+        relinkRaster(&rayPass, "./shd/ray.vert", fragment);
+        volume->setProgram(rayPass.program);
+        camera->setProgram(rayPass.program);
+        reloader->retarget(rayReload, {{"./shd/ray.vert", GL_VERTEX_SHADER}, {fragment, GL_FRAGMENT_SHADER}});
+        currentRenderType = frameConfig->renderType;
+        swapped = true;
+    }
+
+    //the button rebuilds everything the same way a file change would, in the background
+    if(frameConfig->shaderRecompilation){
+        reloader->rebuildAll();
+        frameConfig->shaderRecompilation = false;
+    }
+
+    for(const ShaderReloader::Build &build : reloader->poll()){
+        reloadInstall[build.id](build.program);
+        swapped = true;
+    }
+
+    if(swapped){
+        frameConfig->TAA = false;
+        pBuffer.samples = 0;
+        if(config->debuggingEnabled)config->logMessage("[%f] recompiled shaders \n", glfwGetTime());
+        checkGLError(&success);
+    }
+}
+
+void Renderer::linkCompute(core::ComputePass *pass, const char *shaderFile){
+    pass->shader = compileShader(shaderFile, "COMPUTE", GL_COMPUTE_SHADER);
+    pass->program = glCreateProgram();
+    glAttachShader(pass->program, pass->shader);
+    glLinkProgram(pass->program);
+    glDeleteShader(pass->shader);
+    checkProgramCompileErrors(pass->program);
+    reflectUniforms(pass->program, &pass->uniforms);
+}
+
+void Renderer::linkRaster(core::RasterPass *pass, const char *vertexFile, const char *fragmentFile){
+    pass->vertexShader = compileShader(vertexFile, "VERTEX", GL_VERTEX_SHADER);
+    pass->fragmentShader = compileShader(fragmentFile, "FRAGMENT", GL_FRAGMENT_SHADER);
+    pass->program = glCreateProgram();
+    glAttachShader(pass->program, pass->vertexShader);
+    glAttachShader(pass->program, pass->fragmentShader);
+    glLinkProgram(pass->program);
+    glDeleteShader(pass->vertexShader);
+    glDeleteShader(pass->fragmentShader);
+    checkProgramCompileErrors(pass->program);
+    reflectUniforms(pass->program, &pass->uniforms);
+}
+
+GLuint Renderer::compileShader(const char* path, std::string type, GLuint gl_type){
+    //Read shader from disk
+    std::string shaderCodeRaw;
+    std::ifstream shaderFile;
+    shaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
+    try 
+    {
+        shaderFile.open(path);
+        std::stringstream shaderStream;
+        shaderStream << shaderFile.rdbuf();
+        shaderFile.close();
+        shaderCodeRaw = shaderStream.str();
+    }
+    catch (std::ifstream::failure& e)
+    {
+        if(config->debuggingEnabled)config->logMessage("[%f] RENDERER::ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: %s \n", glfwGetTime(), e.what());
+    }
+    const char* shaderCode = shaderCodeRaw.c_str();
+
+    //compile shader
+    GLuint shader = glCreateShader(gl_type);
+    glShaderSource(shader, 1, &shaderCode, NULL);
+    glCompileShader(shader);
+    int success_s;
+    char infoLog[1024];
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success_s);
+    if(success_s) return shader;
+    glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+    config->logMessage("[%f] RENDERER::SHADER_COMPILATION_ERROR\n %s \n", glfwGetTime(), infoLog);
+    return shader;
+}
+
+void Renderer::relinkRaster(core::RasterPass *pass, const char *vertexFile, const char *fragmentFile){
+    pass->vertexShader = compileShader(vertexFile, "VERTEX", GL_VERTEX_SHADER);
+    pass->fragmentShader = compileShader(fragmentFile, "FRAGMENT", GL_FRAGMENT_SHADER);
+    GLuint newProgram = glCreateProgram();
+    glAttachShader(newProgram, pass->vertexShader);
+    glAttachShader(newProgram, pass->fragmentShader);
+    glLinkProgram(newProgram);
+    checkProgramCompileErrors(newProgram);
+    glDeleteProgram(pass->program);
+    pass->program = newProgram;
+    reflectUniforms(pass->program, &pass->uniforms);
+}
+
+//programs rebuilt in the background replace the pass program only once they linked
+uint32_t Renderer::watchCompute(core::ComputePass *pass, const char *shaderFile){
+    reloadInstall.push_back([this, pass](GLuint program){
+        glDeleteProgram(pass->program);
+        pass->program = program;
+        reflectUniforms(pass->program, &pass->uniforms);
+    });
+    return reloader->watch({{shaderFile, GL_COMPUTE_SHADER}});
+}
+
+uint32_t Renderer::watchRaster(core::RasterPass *pass, const char *vertexFile, const char *fragmentFile){
+    reloadInstall.push_back([this, pass](GLuint program){
+        glDeleteProgram(pass->program);
+        pass->program = program;
+        reflectUniforms(pass->program, &pass->uniforms);
+        if(pass == &rayPass){
+            volume->setProgram(rayPass.program);
+            camera->setProgram(rayPass.program);
+        }
+    });
+    return reloader->watch({{vertexFile, GL_VERTEX_SHADER}, {fragmentFile, GL_FRAGMENT_SHADER}});
+}
+
+//the only place uniforms are looked up by name, passes index the cached locations every frame
+void Renderer::reflectUniforms(GLuint program, core::PassUniforms *uniforms){
+    for(int i = 0; i < core::UNIFORM_COUNT; i++)
+        uniforms->location[i] = glGetUniformLocation(program, uniformNames[i]);
+
+    //blocks keep fixed binding points, so the buffers bound once at startup stay valid across relinks
+    const char *blocks[] = {"CameraUniform", "FrameUniform"};
+    const GLuint bindings[] = {0, FRAME_UBO_BINDING};
+    for(int i = 0; i < 2; i++){
+        GLuint index = glGetUniformBlockIndex(program, blocks[i]);
+        if(index != GL_INVALID_INDEX)
+            glUniformBlockBinding(program, index, bindings[i]);
+    }
+}
+
+void Renderer::checkProgramCompileErrors(unsigned int program)
+{
+    int success;
+    char infoLog[1024];
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if(success) return;
+    glGetProgramInfoLog(program, 1024, NULL, infoLog);
+    config->logMessage("[%f] RENDERER::PROGRAM_LINKING_ERROR \n %s \n", glfwGetTime(), infoLog);
+}
+
+void Renderer::checkGLError(bool *success_s){
+    GLenum error;
+    while((error = glGetError()) != GL_NO_ERROR)
+    {
+        config->logMessage("[%f] RENDERER::OPENGL_ERROR: %u \n", glfwGetTime(), (unsigned int)error);
+        *success_s = false;
+    }
+}
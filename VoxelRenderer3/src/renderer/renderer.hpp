@@ -1,45 +1,117 @@
-#pragma once
-#include "core.hpp"
-#include "octree.hpp"
-#include "camera.hpp"
-#include "material.hpp"
-
-class Renderer{
-    public:
-    Renderer(core::RendererConfig *config_, Octree *volume_, Camera *camera_, MaterialPool *materialPool_);
-    bool run(core::FrameConfig *frameConfig);
-    ~Renderer();
-
-    core::RendererConfig *config;
-    core::DebugInfo debug;
-
-    core::RasterPass rayPass;
-    core::RasterPass finalPass;
-
-    const char* glsl_version = "#version 430";
-    private:
-    bool success = true;
-    core::runtimeRendererMem rrm;
-
-    core::lightingBuffer lBuffer;
- 
-    core::ComputePass accumPass;
-    core::ComputePass avgPass;
-
-    core::RenderType currentRenderType = core::RenderType::DEFAULT;
-
-    Octree *volume;
-    Camera *camera;
-    MaterialPool *materialPool;
-
-    void framebufferEvent();
-    void handleShaderRecompilation(core::FrameConfig *frameConfig);
-    float* genQuad(glm::vec2 size, glm::vec2 tex);
-    void linkCompute(core::ComputePass *pass, const char *shaderFile);
-    void linkRaster(core::RasterPass *pass, const char *vertexFile, const char *fragmentFile);
-    GLuint compileShader(const char* path, std::string type, GLuint gl_type);
-    void relinkCompute(core::ComputePass *pass, const char *shaderFile);
-    void relinkRaster(core::RasterPass *pass, const char *vertexFile, const char *fragmentFile);
-    void checkProgramCompileErrors(unsigned int shader);
-    void checkGLError(bool *succes);
+#pragma once
+#include "core.hpp"
+#include "octree.hpp"
+#include "camera.hpp"
+#include "material.hpp"
+#include "instances.hpp"
+#include "jobs.hpp"
+#include "rendergraph.hpp"
+#include "capture.hpp"
+#include "shaderreload.hpp"
+
+class LightingHashTable;
+class OcclusionBaker;
+class NormalBaker;
+
+class Renderer{
+    public:
+    Renderer(core::RendererConfig *config_, Octree *volume_, Camera *camera_, MaterialPool *materialPool_, InstanceScene *instances_, JobSystem *jobs_);
+    bool run(core::FrameConfig *frameConfig);
+    ~Renderer();
+
+    core::RendererConfig *config;
+    core::DebugInfo debug;
+
+    core::RasterPass rayPass;
+    core::RasterPass finalPass;
+
+    Capture *capture;
+
+    const char* glsl_version = "#version 430";
+    private:
+    bool success = true;
+    core::runtimeRendererMem rrm;
+
+    RenderGraph graph;
+    RenderGraph::Resource meanTexture, varianceTexture, finalTexture;
+
+    core::lightingBuffer lBuffer;
+    core::gpuCounters traversalStats;   //octree raycasts of rayPass, texels they fetched
+    bool traversalRoped = false;
+    LightingHashTable *lModel;
+    OcclusionBaker *occlusionBaker;
+    NormalBaker *normalBaker;
+    core::gpuTimer accumTimer, avgTimer, beamTimer, coneTimer, rayTimer;
+ 
+    core::ComputePass accumPass;
+    core::ComputePass avgPass;
+    core::ComputePass progPass;
+    core::ComputePass beamPass;
+    core::ComputePass injectPass;
+    core::ComputePass filterPass;
+
+    core::progressiveBuffer pBuffer;
+    core::coneTracingBuffer cBuffer;
+    std::vector<Octree::SlotEdit> coneEdits;    //drained from the volume every frame
+
+    core::FrameUniforms frameUniforms = {};
+    GLuint frameUBO;
+
+    core::RenderType currentRenderType = core::RenderType::DEFAULT;
+
+    ShaderReloader *reloader;
+    std::vector<std::function<void(GLuint)>> reloadInstall;    //swaps a rebuilt program in, by reload id
+    uint32_t rayReload;
+
+    Octree *volume;
+    Camera *camera;
+    MaterialPool *materialPool;
+    InstanceScene *instances;
+    JobSystem *jobs;
+    double octreeStatsAt = 0.0;
+
+    JobSystem::Handle compactJob;   //null while no compaction runs
+    std::shared_ptr<Octree::Compaction> compaction;
+    double rayAverageMs = 0.0;      //ray pass time averaged over frames, compared around a compaction
+    uint32_t compactedFrames = 0;
+    void updateCompaction(core::FrameConfig *frameConfig);
+    void clearLightingBuffer();
+    bool pathClock = false;         //frameConfig->clock drives the frame uniforms instead of wall time
+
+    void framebufferEvent();
+    bool progressiveReset(core::FrameConfig *frameConfig);
+    void progressiveReadback(core::FrameConfig *frameConfig);
+    void readLightingStats();
+    void readTraversalStats();
+    void updateFrameUniforms(core::FrameConfig *frameConfig, bool countStats, bool countConvergence);
+    void recordVoxelStream(GLuint idTexture);
+    void replayVoxelStream();
+    void reportModel(const LightingHashTable &model);
+    void coneTracingTrack(bool coneTracing);
+    void coneTracingRebuild();
+    void coneTracingGrow();
+    void coneTracingPatch(const std::vector<Octree::SlotEdit> &edits);
+    void coneTracingUnlist(uint32_t slot);
+    void coneTracingUpload();
+    void coneTracingUpdate(core::FrameConfig *frameConfig);
+    void genCounters(core::gpuCounters *counters, uint32_t count);
+    bool beginCounting(core::gpuCounters *counters);
+    void endCounting(core::gpuCounters *counters);
+    bool readCounters(core::gpuCounters *counters, GLuint *values);
+    void discardCounters(core::gpuCounters *counters);
+    void freeCounters(core::gpuCounters *counters);
+    bool beginTimer(core::gpuTimer *timer);
+    void endTimer(core::gpuTimer *timer);
+    bool readTimer(core::gpuTimer *timer, double *ms, uint64_t *frame);
+    void handleShaderRecompilation(core::FrameConfig *frameConfig);
+    float* genQuad(glm::vec2 size, glm::vec2 tex);
+    void linkCompute(core::ComputePass *pass, const char *shaderFile);
+    void linkRaster(core::RasterPass *pass, const char *vertexFile, const char *fragmentFile);
+    GLuint compileShader(const char* path, std::string type, GLuint gl_type);
+    void relinkRaster(core::RasterPass *pass, const char *vertexFile, const char *fragmentFile);
+    uint32_t watchCompute(core::ComputePass *pass, const char *shaderFile);
+    uint32_t watchRaster(core::RasterPass *pass, const char *vertexFile, const char *fragmentFile);
+    void reflectUniforms(GLuint program, core::PassUniforms *uniforms);
+    void checkProgramCompileErrors(unsigned int shader);
+    void checkGLError(bool *succes);
 };
\ No newline at end of file
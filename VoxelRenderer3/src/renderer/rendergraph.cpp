@@ -0,0 +1,337 @@
+#include "rendergraph.hpp"
+
+RenderGraph::Pass &RenderGraph::Pass::use(Resource resource, Access access){
+    accesses.push_back({resource, access});
+    return *this;
+}
+
+RenderGraph::Pass &RenderGraph::Pass::attach(Resource resource){
+    attachments.push_back(resource);
+    return use(resource, ATTACHMENT);
+}
+
+RenderGraph::RenderGraph(core::RendererConfig *config_) : config(config_){
+}
+
+RenderGraph::~RenderGraph(){
+    release();
+}
+
+RenderGraph::Resource RenderGraph::persistent(const char *name, TextureDesc desc){
+    resources.push_back({name, PERSISTENT, false, desc, 0, (int32_t)pool.size(), -1, -1});
+    pool.push_back({desc, 0, true, -1});
+    persistentStates.push_back(State());
+    persistentCount = resources.size();
+    return resources.size() - 1;
+}
+
+void RenderGraph::resize(glm::ivec2 size_){
+    if(size_ == size)
+        return;
+    size = size_;
+    release();
+    for(State &s : persistentStates)
+        s = State();
+}
+
+void RenderGraph::begin(){
+    resources.resize(persistentCount);
+    passes.clear();
+}
+
+RenderGraph::Resource RenderGraph::transient(const char *name, TextureDesc desc){
+    resources.push_back({name, TRANSIENT, false, desc, 0, -1, -1, -1});
+    return resources.size() - 1;
+}
+
+RenderGraph::Resource RenderGraph::import(const char *name, GLuint object, bool buffer){
+    resources.push_back({name, IMPORTED, buffer, TextureDesc{0}, object, -1, -1, -1});
+    return resources.size() - 1;
+}
+
+RenderGraph::Pass &RenderGraph::pass(const char *name, std::function<void()> execute){
+    passes.emplace_back();
+    passes.back().name = name;
+    passes.back().execute = std::move(execute);
+    return passes.back();
+}
+
+GLuint RenderGraph::texture(Resource resource) const{
+    return resources[resource].object;
+}
+
+void RenderGraph::execute(){
+    compile();
+
+    stats.barriers = 0;
+    for(size_t i = 0; i < order.size(); i++){
+        Pass &pass = passes[order[i]];
+        if(barriers[i]){
+            glMemoryBarrier(barriers[i]);
+            stats.barriers++;
+        }
+        if(!pass.attachments.empty())
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer(pass));
+        pass.execute();
+    }
+}
+
+void RenderGraph::compile(){
+    cull();
+
+    for(ResourceInfo &resource : resources)
+        resource.first = resource.last = -1;
+    for(size_t i = 0; i < order.size(); i++){
+        for(const std::pair<Resource, Access> &access : passes[order[i]].accesses){
+            ResourceInfo &resource = resources[access.first];
+            if(resource.first < 0)
+                resource.first = i;
+            resource.last = i;
+        }
+    }
+
+    alias();
+    placeBarriers();
+}
+
+//walks back from the passes with visible effects, keeping the writers of everything they read
+void RenderGraph::cull(){
+    std::vector<bool> keep(passes.size(), false), wanted(resources.size(), false);
+    for(int32_t i = (int32_t)passes.size() - 1; i >= 0; i--){
+        bool anyWrite = false;
+        for(const std::pair<Resource, Access> &access : passes[i].accesses){
+            bool transient = resources[access.first].lifetime == TRANSIENT;
+            if(access.second == READBACK || (writes(access.second) && (!transient || wanted[access.first])))
+                keep[i] = true;
+            anyWrite |= writes(access.second);
+        }
+        //draws to the default framebuffer or something else the graph doesn't track
+        if(!anyWrite)
+            keep[i] = true;
+        if(!keep[i])
+            continue;
+        for(const std::pair<Resource, Access> &access : passes[i].accesses)
+            if(access.second != ATTACHMENT)
+                wanted[access.first] = true;
+    }
+
+    order.clear();
+    for(size_t i = 0; i < passes.size(); i++)
+        if(keep[i])
+            order.push_back(i);
+    stats.passes = order.size();
+    stats.culled = passes.size() - order.size();
+}
+
+//first fit over the transients sorted by first use, a pool texture is free again after the last use of its previous owner
+void RenderGraph::alias(){
+    for(Texture &texture : pool)
+        texture.busyUntil = -1;
+
+    std::vector<Resource> transients;
+    for(Resource r = 0; r < resources.size(); r++){
+        ResourceInfo &resource = resources[r];
+        if(resource.lifetime == PERSISTENT){
+            Texture &texture = pool[resource.slot];
+            if(texture.name == 0)
+                texture.name = allocate(texture);
+            resource.object = texture.name;
+        }else if(resource.lifetime == TRANSIENT){
+            resource.object = 0;
+            resource.slot = -1;
+            if(resource.first >= 0)
+                transients.push_back(r);
+        }
+    }
+    std::stable_sort(transients.begin(), transients.end(), [this](Resource a, Resource b){ return resources[a].first < resources[b].first; });
+
+    stats.unaliasedBytes = 0;
+    for(Resource r : transients){
+        ResourceInfo &resource = resources[r];
+        size_t slot = 0;
+        while(slot < pool.size() && (pool[slot].persistent || pool[slot].busyUntil >= resource.first ||
+            pool[slot].desc.format != resource.desc.format || pool[slot].desc.divisor != resource.desc.divisor || pool[slot].desc.filter != resource.desc.filter))
+            slot++;
+        if(slot == pool.size())
+            pool.push_back({resource.desc, 0, false, -1});
+
+        Texture &texture = pool[slot];
+        if(texture.name == 0)
+            texture.name = allocate(texture);
+        texture.busyUntil = resource.last;
+        resource.object = texture.name;
+        resource.slot = slot;
+        stats.unaliasedBytes += bytes(resource.desc);
+    }
+
+    //textures of transients missing this frame are kept, toggling a pass shouldn't reallocate
+    stats.transientBytes = stats.persistentBytes = 0;
+    for(const Texture &texture : pool){
+        if(texture.name == 0)
+            continue;
+        if(texture.persistent)
+            stats.persistentBytes += bytes(texture.desc);
+        else
+            stats.transientBytes += bytes(texture.desc);
+    }
+}
+
+// Every incoherent write needs a barrier with the bit of its consumer somewhere between the
+// writer and the first pass reading it that way. Taking the requirements by deadline and reusing
+// the latest barrier whenever it already lies after the write gives the fewest barriers.
+void RenderGraph::placeBarriers(){
+    struct Requirement{
+        int32_t after;      //last write, -1 for writes of previous frames
+        int32_t before;     //first consumer
+        GLbitfield bit;
+    };
+
+    std::vector<State> states(resources.size());
+    std::vector<int32_t> lastWrite(resources.size(), -1);
+    std::vector<Requirement> requirements;
+    for(Resource r = 0; r < resources.size(); r++)
+        if(resources[r].lifetime != TRANSIENT)
+            states[r] = state(r);
+
+    stats.blanketBarriers = 0;
+    for(int32_t i = 0; i < (int32_t)order.size(); i++){
+        const Pass &pass = passes[order[i]];
+        bool anyWrite = false;
+        for(const std::pair<Resource, Access> &access : pass.accesses){
+            State &s = states[access.first];
+            GLbitfield bit = barrierBit(access.second, resources[access.first].buffer);
+            if(s.dirty && !(s.visible & bit)){
+                requirements.push_back({lastWrite[access.first], i, bit});
+                s.visible |= bit;
+            }
+        }
+        for(const std::pair<Resource, Access> &access : pass.accesses){
+            if(!writes(access.second))
+                continue;
+            State &s = states[access.first];
+            s.dirty = incoherent(access.second);
+            s.visible = 0;
+            lastWrite[access.first] = i;
+            anyWrite = true;
+        }
+        if(anyWrite && i + 1 < (int32_t)order.size())
+            stats.blanketBarriers++;
+    }
+
+    //requirements come out ordered by deadline
+    barriers.assign(order.size(), 0);
+    int32_t latest = -1;
+    for(const Requirement &requirement : requirements){
+        if(latest <= requirement.after)
+            latest = requirement.before;
+        barriers[latest] |= requirement.bit;
+    }
+
+    //pending writes of resources outliving the frame carry over with the bits issued after them
+    for(Resource r = 0; r < resources.size(); r++){
+        if(resources[r].lifetime == TRANSIENT)
+            continue;
+        State end = states[r];
+        if(end.dirty)
+            for(int32_t i = lastWrite[r] + 1; i < (int32_t)order.size(); i++)
+                end.visible |= barriers[i];
+        state(r) = end;
+    }
+}
+
+RenderGraph::State &RenderGraph::state(Resource resource){
+    const ResourceInfo &info = resources[resource];
+    if(info.lifetime == PERSISTENT)
+        return persistentStates[resource];
+    return importedStates[{info.object, info.buffer}];
+}
+
+GLuint RenderGraph::framebuffer(const Pass &pass){
+    std::vector<GLuint> textures;
+    for(Resource r : pass.attachments)
+        textures.push_back(resources[r].object);
+    for(const std::pair<std::vector<GLuint>, GLuint> &cached : framebuffers)
+        if(cached.first == textures)
+            return cached.second;
+
+    GLuint fbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    std::vector<GLenum> drawBuffers;
+    for(size_t i = 0; i < textures.size(); i++){
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, textures[i], 0);
+        drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + i);
+    }
+    glDrawBuffers(drawBuffers.size(), drawBuffers.data());
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        config->logMessage("RENDERER::ERROR::FRAMEBUFFER:: %s framebuffer is not complete! \n", pass.name);
+
+    framebuffers.push_back({textures, fbo});
+    return fbo;
+}
+
+GLuint RenderGraph::allocate(const Texture &texture) const{
+    glm::ivec2 extent = glm::max((size + glm::ivec2(texture.desc.divisor - 1)) / glm::ivec2(texture.desc.divisor), glm::ivec2(1));
+    GLuint name;
+    glGenTextures(1, &name);
+    glBindTexture(GL_TEXTURE_2D, name);
+    glTexStorage2D(GL_TEXTURE_2D, 1, texture.desc.format, extent.x, extent.y);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.desc.filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture.desc.filter);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return name;
+}
+
+size_t RenderGraph::bytes(const TextureDesc &desc) const{
+    size_t texel;
+    switch(desc.format){
+        case GL_R32F:
+        case GL_R32UI:
+        case GL_RGBA8:
+            texel = 4;
+            break;
+        case GL_RGBA16F:
+        case GL_RG32UI:
+            texel = 8;
+            break;
+        default:
+            texel = 16;
+            break;
+    }
+    glm::ivec2 extent = glm::max((size + glm::ivec2(desc.divisor - 1)) / glm::ivec2(desc.divisor), glm::ivec2(1));
+    return (size_t)extent.x * extent.y * texel;
+}
+
+void RenderGraph::release(){
+    for(Texture &texture : pool){
+        if(texture.name)
+            glDeleteTextures(1, &texture.name);
+        texture.name = 0;
+    }
+    for(std::pair<std::vector<GLuint>, GLuint> &cached : framebuffers)
+        glDeleteFramebuffers(1, &cached.second);
+    framebuffers.clear();
+}
+
+bool RenderGraph::incoherent(Access access){
+    return access == IMAGE_WRITE || access == STORAGE_WRITE || access == COUNTER;
+}
+
+bool RenderGraph::writes(Access access){
+    return incoherent(access) || access == ATTACHMENT;
+}
+
+GLbitfield RenderGraph::barrierBit(Access access, bool buffer){
+    switch(access){
+        case SAMPLED: return GL_TEXTURE_FETCH_BARRIER_BIT;
+        case IMAGE_READ:
+        case IMAGE_WRITE: return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+        case ATTACHMENT: return GL_FRAMEBUFFER_BARRIER_BIT;
+        case STORAGE_READ:
+        case STORAGE_WRITE: return GL_SHADER_STORAGE_BARRIER_BIT;
+        case COUNTER: return GL_ATOMIC_COUNTER_BARRIER_BIT;
+        case READBACK: return buffer ? GL_BUFFER_UPDATE_BARRIER_BIT : GL_TEXTURE_UPDATE_BARRIER_BIT;
+    }
+    return 0;
+}
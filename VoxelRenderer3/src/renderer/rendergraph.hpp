@@ -0,0 +1,137 @@
+#pragma once
+
+#include "core.hpp"
+
+#include <map>
+
+// Frame graph of the renderer. Passes are declared every frame together with the resources
+// they touch and how, the graph then culls passes nobody reads from, places the fewest memory
+// barriers covering every incoherent write (image stores, storage buffers, atomic counters)
+// before its first consumer, and hands out framebuffer sized textures. Transient textures only
+// live within a frame, transients of the same format whose lifetimes don't overlap share one
+// texture. Every graph owned texture is recreated by resize().
+class RenderGraph{
+    public:
+        typedef uint32_t Resource;
+
+        enum Access{
+            SAMPLED,        //texture()/texelFetch through a sampler
+            IMAGE_READ,     //imageLoad
+            IMAGE_WRITE,    //imageStore and image atomics, read-modify-write included
+            ATTACHMENT,     //color attachment of the pass framebuffer
+            STORAGE_READ,   //shader storage buffer
+            STORAGE_WRITE,
+            COUNTER,        //atomic counter buffer
+            READBACK        //read by the CPU, glGetTexImage or a fence a later glGetBufferSubData waits on
+        };
+
+        struct TextureDesc{
+            GLenum format;              //sized internal format
+            uint32_t divisor = 1;       //framebuffer pixels per texel along each axis, rounded up
+            GLenum filter = GL_NEAREST;
+        };
+
+        class Pass{
+            public:
+                friend class RenderGraph;
+                Pass &use(Resource resource, Access access);
+                //color attachments in declaration order, the graph binds a matching framebuffer
+                Pass &attach(Resource resource);
+            private:
+                const char *name;
+                std::function<void()> execute;
+                std::vector<std::pair<Resource, Access>> accesses;
+                std::vector<Resource> attachments;
+        };
+
+        struct Stats{
+            uint32_t passes = 0;            //executed last frame
+            uint32_t culled = 0;
+            uint32_t barriers = 0;          //glMemoryBarrier calls
+            uint32_t blanketBarriers = 0;   //one after every writing pass, as the passes used to be wired
+            size_t transientBytes = 0;      //pool textures backing the transients
+            size_t unaliasedBytes = 0;      //the same transients with one texture each
+            size_t persistentBytes = 0;
+        };
+
+        explicit RenderGraph(core::RendererConfig *config_);
+        ~RenderGraph();
+
+        //graph owned texture kept across frames, declared once before the first frame
+        Resource persistent(const char *name, TextureDesc desc);
+        //recreates every graph owned texture, persistent contents are lost
+        void resize(glm::ivec2 size_);
+
+        //starts declaring a frame, transients and imports only live until execute()
+        void begin();
+        Resource transient(const char *name, TextureDesc desc);
+        Resource import(const char *name, GLuint object, bool buffer = false);
+        //the reference is only valid until the next pass is added
+        Pass &pass(const char *name, std::function<void()> execute);
+        void execute();
+
+        //GL texture behind a resource, valid inside the pass bodies
+        GLuint texture(Resource resource) const;
+
+        Stats stats;
+
+    private:
+        enum Lifetime{
+            TRANSIENT,
+            PERSISTENT,
+            IMPORTED
+        };
+
+        //whether an incoherent write is pending and which barrier bits were issued since
+        struct State{
+            bool dirty = false;
+            GLbitfield visible = 0;
+        };
+
+        struct ResourceInfo{
+            const char *name;
+            Lifetime lifetime;
+            bool buffer;
+            TextureDesc desc;
+            GLuint object;      //imported object or the pool texture, 0 while unassigned
+            int32_t slot;       //pool entry of graph owned textures, -1 otherwise
+            int32_t first, last;    //positions in the executed order, -1 when unused
+        };
+
+        struct Texture{
+            TextureDesc desc;
+            GLuint name = 0;
+            bool persistent;
+            int32_t busyUntil;
+        };
+
+        core::RendererConfig *config;
+        glm::ivec2 size = glm::ivec2(0);
+
+        std::vector<ResourceInfo> resources;
+        uint32_t persistentCount = 0;
+        std::vector<State> persistentStates;
+        std::map<std::pair<GLuint, bool>, State> importedStates;
+
+        std::vector<Pass> passes;
+        std::vector<uint32_t> order;
+        std::vector<GLbitfield> barriers;     //issued before order[i]
+
+        std::vector<Texture> pool;
+        std::vector<std::pair<std::vector<GLuint>, GLuint>> framebuffers;
+
+        void compile();
+        void cull();
+        void alias();
+        void placeBarriers();
+
+        State &state(Resource resource);
+        GLuint framebuffer(const Pass &pass);
+        GLuint allocate(const Texture &texture) const;
+        size_t bytes(const TextureDesc &desc) const;
+        void release();
+
+        static bool incoherent(Access access);
+        static bool writes(Access access);
+        static GLbitfield barrierBit(Access access, bool buffer);
+};
@@ -0,0 +1,235 @@
+#include "shaderreload.hpp"
+
+#include <filesystem>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+ShaderReloader::ShaderReloader(Config config_, core::RendererConfig *rendererConfig_) : config(config_), rendererConfig(rendererConfig_){
+    //the hidden window inherits the hints of the main one, so both contexts match
+    GLFWwindow *shared = glfwGetCurrentContext();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    context = glfwCreateWindow(1, 1, "shader compiler", nullptr, shared);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if(context)
+        thread = std::thread(&ShaderReloader::loop, this);
+    else
+        rendererConfig->logMessage("[%f] could not create the shader compile context, reloads are compiled on the main thread \n", glfwGetTime());
+
+#ifdef __linux__
+    //editors either rewrite the file in place or rename a new one over it
+    watcher = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(watcher >= 0 && inotify_add_watch(watcher, config.directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0){
+        close(watcher);
+        watcher = -1;
+    }
+#endif
+    if(rendererConfig->debuggingEnabled)rendererConfig->logMessage("[%f] watching %s for shader changes (%s) \n", glfwGetTime(), config.directory, watcher >= 0 ? "inotify" : "polling");
+}
+
+ShaderReloader::~ShaderReloader(){
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    if(thread.joinable())
+        thread.join();
+    if(context)
+        glfwDestroyWindow(context);
+    for(Result &result : results)
+        if(result.program)
+            glDeleteProgram(result.program);
+#ifdef __linux__
+    if(watcher >= 0)
+        close(watcher);
+#endif
+}
+
+uint32_t ShaderReloader::watch(Sources sources){
+    programs.push_back({std::move(sources), 0});
+    for(const std::pair<std::string, GLenum> &source : programs.back().sources){
+        std::error_code error;
+        writeTimes[source.first] = std::filesystem::last_write_time(source.first, error).time_since_epoch().count();
+    }
+    return programs.size() - 1;
+}
+
+void ShaderReloader::retarget(uint32_t id, Sources sources){
+    programs[id].sources = std::move(sources);
+    programs[id].generation++;
+    for(const std::pair<std::string, GLenum> &source : programs[id].sources){
+        std::error_code error;
+        writeTimes[source.first] = std::filesystem::last_write_time(source.first, error).time_since_epoch().count();
+    }
+}
+
+void ShaderReloader::rebuild(uint32_t id){
+    Job job = {id, programs[id].generation, programs[id].sources};
+    if(!context){
+        std::lock_guard<std::mutex> guard(lock);
+        results.push_back(compile(job));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        //a save burst only needs the last version built
+        for(Job &queued : queue){
+            if(queued.id == id){
+                queued = job;
+                return;
+            }
+        }
+        queue.push_back(job);
+    }
+    wake.notify_one();
+}
+
+void ShaderReloader::rebuildAll(){
+    for(uint32_t id = 0; id < programs.size(); id++)
+        rebuild(id);
+}
+
+std::vector<ShaderReloader::Build> ShaderReloader::poll(){
+#ifdef __linux__
+    if(watcher >= 0){
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while((length = read(watcher, buffer, sizeof(buffer))) > 0){
+            for(char *p = buffer; p < buffer + length;){
+                inotify_event *event = (inotify_event*)p;
+                if(event->len > 0)
+                    changed(event->name);
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+#endif
+    if(watcher < 0 && glfwGetTime() - polledAt >= config.pollSeconds){
+        polledAt = glfwGetTime();
+        pollWriteTimes();
+    }
+
+    std::vector<Result> finished;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        finished.swap(results);
+    }
+
+    std::vector<Build> builds;
+    for(Result &result : finished){
+        const Sources &sources = programs[result.id].sources;
+        const char *name = sources.back().first.c_str();
+        if(result.generation != programs[result.id].generation){
+            if(result.program)
+                glDeleteProgram(result.program);
+        }else if(!result.program){
+            rendererConfig->logMessage("[%f] RENDERER::SHADER_RELOAD_ERROR %s, keeping the previous program \n %s \n", glfwGetTime(), name, result.log.c_str());
+        }else{
+            rendererConfig->logMessage("[%f] reloaded %s \n", glfwGetTime(), name);
+            builds.push_back({result.id, result.program});
+        }
+    }
+    return builds;
+}
+
+void ShaderReloader::changed(const std::string &file){
+    for(uint32_t id = 0; id < programs.size(); id++){
+        for(const std::pair<std::string, GLenum> &source : programs[id].sources){
+            if(fileName(source.first) == file){
+                rebuild(id);
+                break;
+            }
+        }
+    }
+}
+
+void ShaderReloader::pollWriteTimes(){
+    for(std::pair<const std::string, int64_t> &file : writeTimes){
+        std::error_code error;
+        int64_t time = std::filesystem::last_write_time(file.first, error).time_since_epoch().count();
+        if(error || time == file.second)
+            continue;
+        file.second = time;
+        changed(fileName(file.first));
+    }
+}
+
+void ShaderReloader::loop(){
+    Profiler::setThreadName("shader compiler");
+    glfwMakeContextCurrent(context);
+    while(true){
+        Job job;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [this](){ return stopping || !queue.empty(); });
+            if(stopping)
+                break;
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+        Result result = compile(job);
+        std::lock_guard<std::mutex> guard(lock);
+        results.push_back(std::move(result));
+    }
+    glfwMakeContextCurrent(nullptr);
+}
+
+ShaderReloader::Result ShaderReloader::compile(const Job &job){
+    PROFILE_ZONE("shader compile");
+    Result result = {job.id, job.generation, 0, ""};
+    GLuint program = glCreateProgram();
+    bool compiled = true;
+    for(const std::pair<std::string, GLenum> &source : job.sources){
+        std::ifstream file(source.first);
+        if(!file){
+            result.log += "could not read " + source.first + "\n";
+            compiled = false;
+            continue;
+        }
+        std::stringstream stream;
+        stream << file.rdbuf();
+        std::string code = stream.str();
+        const char *text = code.c_str();
+
+        GLuint shader = glCreateShader(source.second);
+        glShaderSource(shader, 1, &text, NULL);
+        glCompileShader(shader);
+        int status;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if(!status){
+            char infoLog[1024];
+            glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+            result.log += source.first + ":\n" + infoLog;
+            compiled = false;
+        }
+        glAttachShader(program, shader);
+        glDeleteShader(shader);
+    }
+
+    if(compiled){
+        glLinkProgram(program);
+        int status;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if(status){
+            result.program = program;
+        }else{
+            char infoLog[1024];
+            glGetProgramInfoLog(program, 1024, NULL, infoLog);
+            result.log += infoLog;
+        }
+    }
+    if(!result.program)
+        glDeleteProgram(program);
+
+    //the main context only sees a complete program once this one has finished with it
+    glFinish();
+    return result;
+}
+
+std::string ShaderReloader::fileName(const std::string &path){
+    return std::filesystem::path(path).filename().string();
+}
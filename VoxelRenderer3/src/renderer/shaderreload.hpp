@@ -0,0 +1,85 @@
+#pragma once
+
+#include "core.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+
+// Rebuilds programs whose shader files changed on disk without stalling the frame. The shader
+// directory is watched with inotify (file times are polled elsewhere), affected programs are
+// compiled and linked on a thread owning a hidden context shared with the main one, and only
+// programs that linked are handed back to be swapped in. Failed builds are logged and dropped,
+// the pass keeps running its previous program.
+class ShaderReloader{
+    public:
+        struct Config{
+            const char *directory;  //every watched file lives directly inside it
+            double pollSeconds;     //file time polling interval where inotify is missing
+        };
+
+        //shader files and their stages, linked into one program
+        typedef std::vector<std::pair<std::string, GLenum>> Sources;
+
+        struct Build{
+            uint32_t id;
+            GLuint program;
+        };
+
+        ShaderReloader(Config config_, core::RendererConfig *rendererConfig_);
+        ~ShaderReloader();
+
+        //starts watching the files of a program, returns the id its builds come back with
+        uint32_t watch(Sources sources);
+        //the program now uses other files, builds of the old ones still in flight are discarded
+        void retarget(uint32_t id, Sources sources);
+        void rebuild(uint32_t id);
+        void rebuildAll();
+
+        //queues programs whose files changed and returns the builds that linked since the last call, never blocks
+        std::vector<Build> poll();
+
+        Config config;
+
+    private:
+        struct Program{
+            Sources sources;
+            uint32_t generation = 0;    //bumped by retarget
+        };
+
+        struct Job{
+            uint32_t id;
+            uint32_t generation;
+            Sources sources;
+        };
+
+        struct Result{
+            uint32_t id;
+            uint32_t generation;
+            GLuint program;     //0 when compiling or linking failed
+            std::string log;
+        };
+
+        core::RendererConfig *rendererConfig;
+        std::vector<Program> programs;
+
+        GLFWwindow *context = nullptr;  //hidden, current on the compile thread only
+        std::thread thread;
+        std::mutex lock;
+        std::condition_variable wake;
+        std::deque<Job> queue;
+        std::vector<Result> results;
+        bool stopping = false;
+
+        int watcher = -1;   //inotify descriptor
+        double polledAt = 0.0;
+        std::map<std::string, int64_t> writeTimes;
+
+        void changed(const std::string &file);
+        void pollWriteTimes();
+        void loop();
+        static Result compile(const Job &job);
+        static std::string fileName(const std::string &path);
+};
@@ -1,13 +1,13 @@
-#include "skybox.hpp"
-
-Skybox::Skybox( const std::string& Directory,
-                const std::string& PosXFilename,
-                const std::string& NegXFilename,
-                const std::string& PosYFilename,
-                const std::string& NegYFilename,
-                const std::string& PosZFilename,
-                const std::string& NegZFilename){
-
-
-
+#include "skybox.hpp"
+
+Skybox::Skybox( const std::string& Directory,
+                const std::string& PosXFilename,
+                const std::string& NegXFilename,
+                const std::string& PosYFilename,
+                const std::string& NegYFilename,
+                const std::string& PosZFilename,
+                const std::string& NegZFilename){
+
+
+
 }
\ No newline at end of file
@@ -0,0 +1,261 @@
+#version 430 core
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out uint VoxelID;   // voxel id + 1, 0 on a miss
+
+in vec4 vertexPosition;
+
+uniform usamplerBuffer octreeTexture;
+uniform usamplerBuffer attributeTexture;    // per node: normal | material << 16, solid voxels below
+uniform uint octreeDepth;
+uniform sampler2D beamTexture;
+
+// per frame values, one std140 block shared by every pass and updated once per frame
+layout (std140) uniform FrameUniform {
+    ivec2 screenResolution;
+    int time;               // ray seed
+    uint lightingTime;      // lighting buffer clock, 10ms ticks
+    int spp;
+    int lightBounces;
+    uint controlchecks;
+    float lodBias;          // 0 always descends to the leaves
+    float ambient;          // 0 disables the baked ambient term
+    uint coneSteps;
+    int beamTileSize;       // 0 when the beam pre-pass is off
+    int instruction;
+    uint updateTime;
+    uint evictAge;
+    int countStats;
+    int fuseAverage;
+    int stride;
+    uint widthShift;
+    uint capacityMask;
+    uint maxProbe;
+    int reset;
+    int countConvergence;
+    int minSamples;
+    float threshold;
+};
+
+#ifndef FLT_MAX
+#define FLT_MAX 3.402823466e+38
+#endif
+
+layout (std140) uniform CameraUniform {
+    vec4 position;
+    vec4 cameraPlane, cameraPlaneRight, cameraPlaneUp;
+} camera;
+
+struct Material {
+    vec3 color, specularColor;
+    float diffuse, specular, metallic;
+    bool emissive;
+    float emissiveIntensity;
+};
+
+//32 bytes, packed by MaterialPool::pack
+struct PackedMaterial {
+    vec3 color;
+    float emissiveIntensity;
+    vec3 specularColor;
+    uint params;
+};
+
+layout (std430, binding = 1) readonly buffer MaterialBuffer {
+    PackedMaterial materials[];
+};
+
+Material loadMaterial(uint index){
+    PackedMaterial packed = materials[index];
+    vec4 params = unpackUnorm4x8(packed.params);
+    return Material(packed.color, packed.specularColor, params.x, params.y, params.z, params.w > 0.5, packed.emissiveIntensity);
+}
+
+// per octree node: premultiplied radiance and opacity, leaves injected by inject.comp, internal nodes filtered by cone_filter.comp
+layout (std430, binding = 3) readonly buffer RadianceBuffer {
+    vec4 radiance[];
+};
+
+const uint type_mask = uint(1), count_mask = uint(14), next_mask = uint(4294967280), material_mask = uint(65528);
+uint octreeLength;
+float pixelSpread;
+
+// a surface crossing a node covers about cells^2 of its voxels
+const float lodCoverage = 0.25;
+
+struct Node {
+    bool type;
+    uint count, next, material, normal;
+};
+
+struct leaf_t { uint size; vec3 position;};
+struct hit_t { bool hit; uint id, material; uvec3 position; uint normal, size;};
+struct ray_t { vec3 origin, direction, inverted_direction;};
+
+Node UnpackNode(uint raw) { return Node(bool(raw & type_mask), (raw & count_mask) >> 1, (raw & next_mask) >> 4, (raw & material_mask) >> 3, raw >> 16u);}
+// octahedral encoding, 8 bits per coordinate, the lower hemisphere is folded over the diagonals
+vec3 UnpackNormal(uint packedNormal) {
+    vec2 e = vec2(float(packedNormal >> 8u & 0xFFu), float(packedNormal & 0xFFu)) * (2.0 / 255.0) - 1.0;
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+bool inVolume(vec3 v) { return all(lessThanEqual(vec3(0), v) && lessThan(v, vec3(float(octreeLength))));}
+bool inBounds(vec3 v, float n) { return all(lessThanEqual(vec3(0), v) && lessThanEqual(v, vec3(n, n, n)));}
+uint locate(uvec3 pos, uint p2) { return (uint(bool(pos.x & p2)) << 2) | (uint(bool(pos.y & p2)) << 1) | uint(bool(pos.z & p2));}
+float lerp(float a, float b, float t){ return a + t * (b - a);}
+vec3 lerp(vec3 a, vec3 b, float t){ return vec3(lerp(a.x,b.x,t), lerp(a.y,b.y,t), lerp(a.z,b.z,t));}
+
+vec3 sampleSkybox(vec3 dir){
+    return dir;
+}
+
+vec4 intersect(ray_t r, vec3 box_min, vec3 box_max) {
+    vec3 t1 = (box_min - r.origin + 0.001) * r.inverted_direction;
+    vec3 t2 = (box_max - r.origin - 0.001) * r.inverted_direction;
+    vec3 tmin = min(t1, t2), tmax = max(t1, t2);
+    float t_enter = max(max(tmin.x, tmin.y), tmin.z);
+    float t_exit = min(min(tmax.x, tmax.y), tmax.z);
+    if (t_exit < t_enter || t_exit < 0) return vec4(0.0, 0.0, 0.0, -1.0);
+    return vec4(r.direction * (t_enter) + r.origin, 1.0);
+}
+
+vec3 intersect_inside(ray_t r, vec3 box_min, vec3 box_max) {
+    vec3 t1 = (box_min - r.origin - 0.001) * r.inverted_direction;
+    vec3 t2 = (box_max - r.origin + 0.001) * r.inverted_direction;
+    vec3 tmin = min(t1, t2), tmax = max(t1, t2);
+    float t_exit = min(min(tmax.x, tmax.y), tmax.z);
+    return r.direction * (t_exit) + r.origin;
+}
+
+hit_t Raycast(ray_t ray) {
+    uint p2c[16];
+    for (int i = 0; i <= int(octreeDepth); i++) {
+        p2c[i] = uint(octreeLength >> uint(i));
+    }
+
+    hit_t voxel = hit_t(false, uint(0), uint(0), uvec3(0,0,0), uint(0), uint(0));
+    uint offset = uint(0), depth = uint(0), q = uint(0);
+    vec3 r_pos;
+
+    ray.origin += ray.direction * 4;
+    
+    if (inBounds(ray.origin, float(octreeLength))) r_pos = ray.origin;
+    else {  vec4 intersection = intersect(ray, vec3(0), vec3(float(octreeLength)));
+            r_pos = intersection.xyz; q++;
+            if (intersection.w < 0.0) return voxel;}
+
+    leaf_t target;
+
+    while (inBounds(r_pos, float(octreeLength)) && q++ <= controlchecks) {
+        uvec3 ur_pos = uvec3(uint(r_pos.x), uint(r_pos.y), uint(r_pos.z));
+        depth = offset = uint(0);
+        bool foundLeaf = false;
+
+        for (; depth < octreeDepth - uint(1); depth++) {
+            offset += locate(ur_pos, p2c[depth]);
+            Node leaf = UnpackNode(texelFetch(octreeTexture, int(offset)).r);
+            if (!leaf.type) {
+                target.size = p2c[depth];
+                target.position = vec3(uvec3(ur_pos) & ~uvec3(target.size - uint(1)));
+                foundLeaf = true;
+                break;
+            }
+            // the node covers less than lodBias pixels, stop at its down-sampled attributes if it is dense enough
+            if (lodBias > 0.0 && float(p2c[depth]) < lodBias * pixelSpread * distance(camera.position.xyz, r_pos)) {
+                uvec2 attribute = texelFetch(attributeTexture, int(offset)).rg;
+                float cells = float(p2c[depth] >> 1);
+                if (float(attribute.g) >= lodCoverage * cells * cells)
+                    return hit_t(true, offset, attribute.r >> 16u, ur_pos & ~uvec3(p2c[depth] - uint(1)), attribute.r & 0xFFFFu, p2c[depth]);
+            }
+            offset = leaf.next;
+        }
+
+        if (!foundLeaf) {
+            offset += locate(ur_pos, p2c[depth]);
+            Node leaf = UnpackNode(texelFetch(octreeTexture, int(offset)).r);
+            target.size = p2c[depth];
+            target.position = vec3(uvec3(ur_pos) & ~uvec3(target.size - uint(1)));
+            if (leaf.material != uint(0)) return hit_t(true, offset, leaf.material, uvec3(target.position), leaf.normal, target.size);
+        }
+
+        r_pos = intersect_inside(ray, target.position, target.position + vec3(target.size));
+    }
+    return voxel;
+}
+
+// radiance of the node holding pos whose size matches the cone diameter
+vec4 sampleHierarchy(vec3 pos, float diameter) {
+    if (!inVolume(pos)) return vec4(0);
+    uvec3 upos = uvec3(pos);
+    uint offset = uint(0);
+    for (uint depth = uint(0); depth < octreeDepth; depth++) {
+        offset += locate(upos, octreeLength >> depth);
+        Node node = UnpackNode(texelFetch(octreeTexture, int(offset)).r);
+        if (!node.type || depth == octreeDepth - uint(1) || float(octreeLength >> (depth + uint(1))) < diameter)
+            return radiance[offset];
+        offset = node.next;
+    }
+    return vec4(0);
+}
+
+// front to back accumulation through coarser and coarser levels, the sky fills what stays transparent
+vec3 coneTrace(vec3 origin, vec3 direction, float tanHalf) {
+    vec4 accumulated = vec4(0);
+    float t = 2.0;
+    for (uint i = uint(0); i < coneSteps && accumulated.a < 0.95; i++) {
+        vec3 p = origin + direction * t;
+        if (!inVolume(p)) break;
+        float diameter = max(2.0, 2.0 * t * tanHalf);
+        accumulated += (1.0 - accumulated.a) * sampleHierarchy(p, diameter);
+        t += 0.5 * diameter;
+    }
+    return accumulated.rgb + (1.0 - accumulated.a) * sampleSkybox(direction);
+}
+
+// 6 cones of 60 degrees, cosine weighted over the hemisphere
+vec3 gatherDiffuse(vec3 origin, vec3 normal) {
+    const float tanHalf = 0.577;
+    vec3 tangent = normalize(cross(normal, abs(normal.y) < 0.99 ? vec3(0, 1, 0) : vec3(1, 0, 0)));
+    vec3 bitangent = cross(normal, tangent);
+
+    vec3 irradiance = 0.25 * coneTrace(origin, normal, tanHalf);
+    for (int i = 0; i < 5; i++) {
+        float angle = float(i) * 1.2566371;
+        vec3 direction = normalize(0.5 * normal + 0.866 * (cos(angle) * tangent + sin(angle) * bitangent));
+        irradiance += 0.15 * coneTrace(origin, direction, tanHalf);
+    }
+    return irradiance;
+}
+
+void main() {
+    vec3 direction = normalize(camera.cameraPlane.xyz + vertexPosition.x * camera.cameraPlaneRight.xyz - vertexPosition.y * camera.cameraPlaneUp.xyz);
+    octreeLength = uint(1) << octreeDepth;
+    pixelSpread = 2.0 * length(camera.cameraPlaneUp.xyz) / float(screenResolution.y);
+
+    ray_t ray;
+    ray.origin = camera.position.xyz;
+    ray.direction = direction;
+    ray.inverted_direction = 1.0 / direction;
+
+    // skip the empty space the beam pre-pass proved for this tile, Raycast itself still adds its offset of 4
+    ray_t primary = ray;
+    if(beamTileSize > 0){
+        float beamStart = texelFetch(beamTexture, ivec2(gl_FragCoord.xy) / beamTileSize, 0).r;
+        primary.origin += direction * max(beamStart - 4.0, 0.0);
+    }
+
+    hit_t voxel = Raycast(primary);
+
+    if(voxel.hit){
+        vec3 normal = normalize(UnpackNormal(voxel.normal));
+        Material mat = loadMaterial(voxel.material);
+        vec3 origin = vec3(voxel.position) + vec3(0.5 * float(voxel.size)) + normal * (0.5 * float(voxel.size));
+
+        vec3 emission = mat.emissive ? mat.color.xyz * mat.emissiveIntensity : vec3(0);
+        FragColor = vec4(emission + mat.color.xyz * gatherDiffuse(origin, normal), 1);
+        VoxelID = voxel.id+1u;
+    }else{
+        FragColor = vec4(sampleSkybox(ray.direction), 1);
+        VoxelID = 0u;
+    }
+}
@@ -1,164 +1,333 @@
-#version 430 core
-out vec4 FragColor;
-
-in vec4 vertexPosition;
-
-uniform usamplerBuffer octreeTexture;
-uniform uint octreeDepth;
-uniform int spp;
-uniform uint controlchecks;
-uniform int lightBounces;
-uniform ivec2 screenResolution;
-uniform int time;
-
-#ifndef FLT_MAX
-#define FLT_MAX 3.402823466e+38
-#endif
-
-layout (std140) uniform CameraUniform {
-    vec4 position;
-    vec4 cameraPlane, cameraPlaneRight, cameraPlaneUp;
-} camera;
-
-struct Material {
-    vec4 color, specularColor;
-    float diffuse, specular, metallic;
-    bool emissive;
-    float emissiveIntensity;
-};
-
-layout (std140) uniform MaterialUniform {
-    Material material[127];
-};
-
-const uint type_mask = uint(1), count_mask = uint(14), next_mask = uint(4294967280), material_mask = uint(254);
-const float inv_127 = 1.0/127.0;
-uint octreeLength;
-
-struct Node {
-    bool type;
-    uint count, next, material, normal;
-};
-
-struct leaf_t { uint size; vec3 position;};
-struct hit_t { bool hit; uint id, material; uvec3 position;};
-struct ray_t { vec3 origin, direction, inverted_direction;};
-
-Node UnpackNode(uint raw) { return Node(bool(raw & type_mask), (raw & count_mask) >> 1, (raw & next_mask) >> 4, (raw & material_mask) >> 1, (raw >> 8u) & 0xFFFFFFu);}
-vec3 UnpackNormal(uint packedNormal) { return vec3(float(int(packedNormal >> 16u & 0xFFu) - 128) * inv_127, float(int(packedNormal >> 8u & 0xFFu) - 128) * inv_127, float(int(packedNormal & 0xFFu) - 128) * inv_127);}
-bool inBounds(vec3 v, float n) { return all(lessThanEqual(vec3(0), v) && lessThanEqual(v, vec3(n, n, n)));}
-uint locate(uvec3 pos, uint p2) { return (uint(bool(pos.x & p2)) << 2) | (uint(bool(pos.y & p2)) << 1) | uint(bool(pos.z & p2));}
-float lerp(float a, float b, float t){ return a + t * (b - a);}
-vec3 lerp(vec3 a, vec3 b, float t){ return vec3(lerp(a.x,b.x,t), lerp(a.y,b.y,t), lerp(a.z,b.z,t));}
-
-float rand(inout uint state){
-    state = state * uint(747796405) + uint(2891336453);
-    uint word = ((state >> ((state >> uint(28)) + uint(4))) ^ state) * uint(277803737);
-    word = (word >> uint(22)) ^ word;
-    return float(word) / 4294967295.0;
-}
-
-float randInNormalDistribution(inout uint state){
-    float theta = 2 * 3.1415926 * rand(state);
-    float rho = sqrt(-2 * log(rand(state)));
-    return rho * cos(theta);
-}
-
-vec3 RandomDirection(inout uint state){
-    float x = randInNormalDistribution(state);
-    float y = randInNormalDistribution(state);
-    float z = randInNormalDistribution(state);
-    return normalize(vec3(x, y, z));
-}
-
-vec3 sampleSkybox(vec3 dir){
-    return dir;
-}
-
-vec4 intersect(ray_t r, vec3 box_min, vec3 box_max) {
-    vec3 t1 = (box_min - r.origin + 0.001) * r.inverted_direction;
-    vec3 t2 = (box_max - r.origin - 0.001) * r.inverted_direction;
-    vec3 tmin = min(t1, t2), tmax = max(t1, t2);
-    float t_enter = max(max(tmin.x, tmin.y), tmin.z);
-    float t_exit = min(min(tmax.x, tmax.y), tmax.z);
-    if (t_exit < t_enter || t_exit < 0) return vec4(0.0, 0.0, 0.0, -1.0);
-    return vec4(r.direction * (t_enter) + r.origin, 1.0);
-}
-
-vec3 intersect_inside(ray_t r, vec3 box_min, vec3 box_max) {
-    vec3 t1 = (box_min - r.origin - 0.001) * r.inverted_direction;
-    vec3 t2 = (box_max - r.origin + 0.001) * r.inverted_direction;
-    vec3 tmin = min(t1, t2), tmax = max(t1, t2);
-    float t_exit = min(min(tmax.x, tmax.y), tmax.z);
-    return r.direction * (t_exit) + r.origin;
-}
-
-hit_t Raycast(ray_t ray) {
-    uint p2c[16];
-    for (int i = 0; i <= int(octreeDepth); i++) {
-        p2c[i] = uint(octreeLength >> uint(i));
-    }
-
-    hit_t voxel = hit_t(false, uint(0), uint(0), uvec3(0,0,0));
-    uint offset = uint(0), depth = uint(0), q = uint(0);
-    vec3 r_pos;
-
-    ray.origin += ray.direction * 4;
-    
-    if (inBounds(ray.origin, float(octreeLength))) r_pos = ray.origin;
-    else {  vec4 intersection = intersect(ray, vec3(0), vec3(float(octreeLength)));
-            r_pos = intersection.xyz; q++;
-            if (intersection.w < 0.0) return voxel;}
-
-    leaf_t target;
-
-    while (inBounds(r_pos, float(octreeLength)) && q++ <= controlchecks) {
-        uvec3 ur_pos = uvec3(uint(r_pos.x), uint(r_pos.y), uint(r_pos.z));
-        depth = offset = uint(0);
-        bool foundLeaf = false;
-
-        for (; depth < octreeDepth - uint(1); depth++) {
-            offset += locate(ur_pos, p2c[depth]);
-            Node leaf = UnpackNode(texelFetch(octreeTexture, int(offset)).r);
-            if (!leaf.type) {
-                target.size = p2c[depth];
-                target.position = vec3(uvec3(ur_pos) & ~uvec3(target.size - uint(1)));
-                foundLeaf = true;
-                break;
-            }
-            offset = leaf.next;
-        }
-
-        if (!foundLeaf) {
-            offset += locate(ur_pos, p2c[depth]);
-            Node leaf = UnpackNode(texelFetch(octreeTexture, int(offset)).r);
-            target.size = p2c[depth];
-            target.position = vec3(uvec3(ur_pos) & ~uvec3(target.size - uint(1)));
-            if (leaf.material != uint(0)) return hit_t(true, offset, leaf.material, uvec3(target.position));
-        }
-
-        r_pos = intersect_inside(ray, target.position, target.position + vec3(target.size));
-    }
-    return voxel;
-}
-
-
-void main() {
-    vec3 direction = normalize(camera.cameraPlane.xyz + vertexPosition.x * camera.cameraPlaneRight.xyz - vertexPosition.y * camera.cameraPlaneUp.xyz);
-    octreeLength = uint(1) << octreeDepth;
-
-    ray_t ray;
-    ray.origin = camera.position.xyz;
-    ray.direction = direction;
-    ray.inverted_direction = 1.0 / direction;
-
-    hit_t voxel = Raycast(ray);
-
-    if(voxel.hit){
-        Node data = UnpackNode(texelFetch(octreeTexture, int(voxel.id)).r);
-        vec3 normal = normalize(UnpackNormal(data.normal));
-        FragColor = vec4(normal.xyz, float(voxel.id+1));
-    }else{
-        FragColor = vec4(sampleSkybox(ray.direction), 0);
-    }
+#version 430 core
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out uint VoxelID;   // voxel id + 1, 0 on a miss
+
+in vec4 vertexPosition;
+
+uniform usamplerBuffer octreeTexture;
+uniform usamplerBuffer attributeTexture;    // per node: normal | material << 16, solid voxels below
+uniform uint octreeDepth;
+uniform sampler2D beamTexture;
+
+// per frame values, one std140 block shared by every pass and updated once per frame
+layout (std140) uniform FrameUniform {
+    ivec2 screenResolution;
+    int time;               // ray seed
+    uint lightingTime;      // lighting buffer clock, 10ms ticks
+    int spp;
+    int lightBounces;
+    uint controlchecks;
+    float lodBias;          // 0 always descends to the leaves
+    float ambient;          // 0 disables the baked ambient term
+    uint coneSteps;
+    int beamTileSize;       // 0 when the beam pre-pass is off
+    int instruction;
+    uint updateTime;
+    uint evictAge;
+    int countStats;
+    int fuseAverage;
+    int stride;
+    uint widthShift;
+    uint capacityMask;
+    uint maxProbe;
+    int reset;
+    int countConvergence;
+    int minSamples;
+    float threshold;
+};
+
+#ifndef FLT_MAX
+#define FLT_MAX 3.402823466e+38
+#endif
+
+layout (std140) uniform CameraUniform {
+    vec4 position;
+    vec4 cameraPlane, cameraPlaneRight, cameraPlaneUp;
+} camera;
+
+struct Material {
+    vec3 color, specularColor;
+    float diffuse, specular, metallic;
+    bool emissive;
+    float emissiveIntensity;
+};
+
+//32 bytes, packed by MaterialPool::pack
+struct PackedMaterial {
+    vec3 color;
+    float emissiveIntensity;
+    vec3 specularColor;
+    uint params;
+};
+
+layout (std430, binding = 1) readonly buffer MaterialBuffer {
+    PackedMaterial materials[];
+};
+
+Material loadMaterial(uint index){
+    PackedMaterial packed = materials[index];
+    vec4 params = unpackUnorm4x8(packed.params);
+    return Material(packed.color, packed.specularColor, params.x, params.y, params.z, params.w > 0.5, packed.emissiveIntensity);
+}
+
+const uint type_mask = uint(1), count_mask = uint(14), next_mask = uint(4294967280), material_mask = uint(65528);
+uint octreeLength;
+float pixelSpread;
+
+// a surface crossing a node covers about cells^2 of its voxels
+const float lodCoverage = 0.25;
+
+struct Node {
+    bool type;
+    uint count, next, material, normal;
+};
+
+struct leaf_t { uint size; vec3 position;};
+struct hit_t { bool hit; uint id, material; uvec3 position; uint normal, size;};
+struct ray_t { vec3 origin, direction, inverted_direction;};
+
+Node UnpackNode(uint raw) { return Node(bool(raw & type_mask), (raw & count_mask) >> 1, (raw & next_mask) >> 4, (raw & material_mask) >> 3, raw >> 16u);}
+// octahedral encoding, 8 bits per coordinate, the lower hemisphere is folded over the diagonals
+vec3 UnpackNormal(uint packedNormal) {
+    vec2 e = vec2(float(packedNormal >> 8u & 0xFFu), float(packedNormal & 0xFFu)) * (2.0 / 255.0) - 1.0;
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+bool inBounds(vec3 v, float n) { return all(lessThanEqual(vec3(0), v) && lessThanEqual(v, vec3(n, n, n)));}
+uint locate(uvec3 pos, uint p2) { return (uint(bool(pos.x & p2)) << 2) | (uint(bool(pos.y & p2)) << 1) | uint(bool(pos.z & p2));}
+float lerp(float a, float b, float t){ return a + t * (b - a);}
+vec3 lerp(vec3 a, vec3 b, float t){ return vec3(lerp(a.x,b.x,t), lerp(a.y,b.y,t), lerp(a.z,b.z,t));}
+
+float rand(inout uint state){
+    state = state * uint(747796405) + uint(2891336453);
+    uint word = ((state >> ((state >> uint(28)) + uint(4))) ^ state) * uint(277803737);
+    word = (word >> uint(22)) ^ word;
+    return float(word) / 4294967295.0;
+}
+
+float randInNormalDistribution(inout uint state){
+    float theta = 2 * 3.1415926 * rand(state);
+    float rho = sqrt(-2 * log(rand(state)));
+    return rho * cos(theta);
+}
+
+vec3 RandomDirection(inout uint state){
+    float x = randInNormalDistribution(state);
+    float y = randInNormalDistribution(state);
+    float z = randInNormalDistribution(state);
+    return normalize(vec3(x, y, z));
+}
+
+vec3 sampleSkybox(vec3 dir){
+    return dir;
+}
+
+vec4 intersect(ray_t r, vec3 box_min, vec3 box_max) {
+    vec3 t1 = (box_min - r.origin + 0.001) * r.inverted_direction;
+    vec3 t2 = (box_max - r.origin - 0.001) * r.inverted_direction;
+    vec3 tmin = min(t1, t2), tmax = max(t1, t2);
+    float t_enter = max(max(tmin.x, tmin.y), tmin.z);
+    float t_exit = min(min(tmax.x, tmax.y), tmax.z);
+    if (t_exit < t_enter || t_exit < 0) return vec4(0.0, 0.0, 0.0, -1.0);
+    return vec4(r.direction * (t_enter) + r.origin, 1.0);
+}
+
+vec3 intersect_inside(ray_t r, vec3 box_min, vec3 box_max) {
+    vec3 t1 = (box_min - r.origin - 0.001) * r.inverted_direction;
+    vec3 t2 = (box_max - r.origin + 0.001) * r.inverted_direction;
+    vec3 tmin = min(t1, t2), tmax = max(t1, t2);
+    float t_exit = min(min(tmax.x, tmax.y), tmax.z);
+    return r.direction * (t_exit) + r.origin;
+}
+
+hit_t Raycast(ray_t ray) {
+    uint p2c[16];
+    for (int i = 0; i <= int(octreeDepth); i++) {
+        p2c[i] = uint(octreeLength >> uint(i));
+    }
+
+    hit_t voxel = hit_t(false, uint(0), uint(0), uvec3(0,0,0), uint(0), uint(0));
+    uint offset = uint(0), depth = uint(0), q = uint(0);
+    vec3 r_pos;
+
+    ray.origin += ray.direction * 4;
+    
+    if (inBounds(ray.origin, float(octreeLength))) r_pos = ray.origin;
+    else {  vec4 intersection = intersect(ray, vec3(0), vec3(float(octreeLength)));
+            r_pos = intersection.xyz; q++;
+            if (intersection.w < 0.0) return voxel;}
+
+    leaf_t target;
+
+    while (inBounds(r_pos, float(octreeLength)) && q++ <= controlchecks) {
+        uvec3 ur_pos = uvec3(uint(r_pos.x), uint(r_pos.y), uint(r_pos.z));
+        depth = offset = uint(0);
+        bool foundLeaf = false;
+
+        for (; depth < octreeDepth - uint(1); depth++) {
+            offset += locate(ur_pos, p2c[depth]);
+            Node leaf = UnpackNode(texelFetch(octreeTexture, int(offset)).r);
+            if (!leaf.type) {
+                target.size = p2c[depth];
+                target.position = vec3(uvec3(ur_pos) & ~uvec3(target.size - uint(1)));
+                foundLeaf = true;
+                break;
+            }
+            // the node covers less than lodBias pixels, stop at its down-sampled attributes if it is dense enough
+            if (lodBias > 0.0 && float(p2c[depth]) < lodBias * pixelSpread * distance(camera.position.xyz, r_pos)) {
+                uvec2 attribute = texelFetch(attributeTexture, int(offset)).rg;
+                float cells = float(p2c[depth] >> 1);
+                if (float(attribute.g) >= lodCoverage * cells * cells)
+                    return hit_t(true, offset, attribute.r >> 16u, ur_pos & ~uvec3(p2c[depth] - uint(1)), attribute.r & 0xFFFFu, p2c[depth]);
+            }
+            offset = leaf.next;
+        }
+
+        if (!foundLeaf) {
+            offset += locate(ur_pos, p2c[depth]);
+            Node leaf = UnpackNode(texelFetch(octreeTexture, int(offset)).r);
+            target.size = p2c[depth];
+            target.position = vec3(uvec3(ur_pos) & ~uvec3(target.size - uint(1)));
+            if (leaf.material != uint(0)) return hit_t(true, offset, leaf.material, uvec3(target.position), leaf.normal, target.size);
+        }
+
+        r_pos = intersect_inside(ray, target.position, target.position + vec3(target.size));
+    }
+    return voxel;
+}
+
+// two level structure: a BVH over instance bounds, every instance places a model octree by a transform
+struct Instance { mat4 worldToLocal; uvec4 model; };   // model: node base, depth, instance index
+struct BVHNode { vec4 boundsMin, boundsMax; uvec4 data; };  // data: left child or first instance, right child or count, leaf
+
+layout (std430, binding = 6) readonly buffer InstanceBuffer { Instance instances[]; };
+layout (std430, binding = 7) readonly buffer BVHBuffer { BVHNode bvh[]; };
+uniform usamplerBuffer modelTexture;
+uniform uint instanceCount;
+
+const uint INSTANCE_BIT = uint(2147483648);
+
+uint PackNormal(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    uvec2 q = uvec2(round(clamp(e * 0.5 + 0.5, 0.0, 1.0) * 255.0));
+    return (q.x << 8) | q.y;
+}
+
+// entry (x) and exit (y) ray parameter of a box, x > y on a miss
+vec2 slabs(ray_t r, vec3 box_min, vec3 box_max) {
+    vec3 t1 = (box_min - r.origin) * r.inverted_direction;
+    vec3 t2 = (box_max - r.origin) * r.inverted_direction;
+    vec3 tmin = min(t1, t2), tmax = max(t1, t2);
+    return vec2(max(max(tmin.x, tmin.y), tmin.z), min(min(tmax.x, tmax.y), tmax.z));
+}
+
+// marches a model octree in its local space, the direction is not normalized so t stays the world ray parameter
+bool RaycastModel(ray_t ray, uint base, uint depth, float tMax, out float t, out uint node, out uint raw) {
+    uint modelLength = uint(1) << depth;
+    vec2 span = slabs(ray, vec3(0), vec3(float(modelLength)));
+    if (span.x > span.y || span.y < 0.0 || span.x > tMax) return false;
+
+    float tCell = max(span.x, 0.0);
+    for (uint i = uint(0); i < controlchecks && tCell < min(span.y, tMax); i++) {
+        vec3 p = ray.origin + ray.direction * (tCell + 0.001);
+        uvec3 up = uvec3(clamp(p, vec3(0), vec3(float(modelLength) - 0.001)));
+
+        uint offset = base, d = uint(0);
+        Node n;
+        for (;; d++) {
+            offset += locate(up, modelLength >> d);
+            n = UnpackNode(texelFetch(modelTexture, int(offset)).r);
+            if (!n.type || d == depth - uint(1)) break;
+            offset = base + n.next;
+        }
+
+        if (!n.type && n.material != uint(0)) {
+            t = tCell;
+            node = offset - base;
+            raw = texelFetch(modelTexture, int(offset)).r;
+            return true;
+        }
+
+        uint size = modelLength >> d;
+        vec3 cellMin = vec3(up & ~uvec3(size - uint(1)));
+        tCell = max(slabs(ray, cellMin, cellMin + vec3(float(size))).y, tCell + 0.001);
+    }
+    return false;
+}
+
+// replaces voxel by the closest instance hit in front of it, instance voxel ids carry INSTANCE_BIT so copies keep their own lighting
+hit_t ClosestHit(ray_t ray, hit_t voxel) {
+    if (instanceCount == uint(0)) return voxel;
+    float tHit = voxel.hit ? slabs(ray, vec3(voxel.position), vec3(voxel.position + uvec3(voxel.size))).x : FLT_MAX;
+
+    uint stack[32];
+    int top = 0;
+    stack[top++] = uint(0);
+    while (top > 0) {
+        BVHNode bvhNode = bvh[stack[--top]];
+        vec2 span = slabs(ray, bvhNode.boundsMin.xyz, bvhNode.boundsMax.xyz);
+        if (span.x > span.y || span.y < 0.0 || span.x > tHit) continue;
+
+        if (bvhNode.data.z == uint(0)) {
+            if (top <= 30) {
+                stack[top++] = bvhNode.data.x;
+                stack[top++] = bvhNode.data.y;
+            }
+            continue;
+        }
+
+        for (uint i = bvhNode.data.x; i < bvhNode.data.x + bvhNode.data.y; i++) {
+            Instance instance = instances[i];
+            ray_t local;
+            local.origin = (instance.worldToLocal * vec4(ray.origin, 1.0)).xyz;
+            local.direction = mat3(instance.worldToLocal) * ray.direction;
+            local.inverted_direction = 1.0 / local.direction;
+
+            float t;
+            uint node, raw;
+            if (RaycastModel(local, instance.model.x, instance.model.y, tHit, t, node, raw)) {
+                Node leaf = UnpackNode(raw);
+                vec3 normal = normalize(transpose(mat3(instance.worldToLocal)) * UnpackNormal(leaf.normal));
+                // instance voxels have no world grid cell, position and size describe a leaf sized cell at the hit point
+                vec3 point = ray.origin + ray.direction * t;
+                uint id = INSTANCE_BIT | (((instance.model.z * uint(2654435761)) ^ node) & ~INSTANCE_BIT);
+                voxel = hit_t(true, id, leaf.material, uvec3(max(point - vec3(1.0), vec3(0))), PackNormal(normal), uint(2));
+                tHit = t;
+            }
+        }
+    }
+    return voxel;
+}
+
+
+void main() {
+    vec3 direction = normalize(camera.cameraPlane.xyz + vertexPosition.x * camera.cameraPlaneRight.xyz - vertexPosition.y * camera.cameraPlaneUp.xyz);
+    octreeLength = uint(1) << octreeDepth;
+    pixelSpread = 2.0 * length(camera.cameraPlaneUp.xyz) / float(screenResolution.y);
+
+    ray_t ray;
+    ray.origin = camera.position.xyz;
+    ray.direction = direction;
+    ray.inverted_direction = 1.0 / direction;
+
+    // skip the empty space the beam pre-pass proved for this tile, Raycast itself still adds its offset of 4
+    ray_t primary = ray;
+    if(beamTileSize > 0){
+        float beamStart = texelFetch(beamTexture, ivec2(gl_FragCoord.xy) / beamTileSize, 0).r;
+        primary.origin += direction * max(beamStart - 4.0, 0.0);
+    }
+
+    // instances are tested along the whole camera ray, the beam pre-pass only knows the world octree
+    hit_t voxel = ClosestHit(ray, Raycast(primary));
+
+    if(voxel.hit){
+        vec3 normal = normalize(UnpackNormal(voxel.normal));
+        FragColor = vec4(normal.xyz, 1);
+        VoxelID = voxel.id+1u;
+    }else{
+        FragColor = vec4(sampleSkybox(ray.direction), 1);
+        VoxelID = 0u;
+    }
 }
\ No newline at end of file
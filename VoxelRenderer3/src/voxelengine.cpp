@@ -1,659 +1,553 @@
-#include "voxelengine.hpp"
-#include "Noise/FractalNoise.h"
-
-
-VoxelEngine::VoxelEngine(const Config *windowConfig){
-    setupContext(windowConfig);
-
-    Info *info = new Info("info");
-    Control *control = new Control("control");
-
-    auto logMessage = [&info](const char* format, va_list args) {
-        info->vAddLog(format, args);
-        vprintf(format, args);
-    };
-
-    auto fbSize = [this](){
-        glm::ivec2 size; 
-        glfwGetFramebufferSize(window, &size.x, &size.y); 
-        return size;
-    };
-
-    core::RendererConfig rendererConfig = {
-        .log = logMessage,
-        .framebufferSize = fbSize,
-        .aspectRatio = windowConfig->viewportAspectRatio,
-        .debuggingEnabled = false
-    };
-
-    Octree::Config octreeConfig = {
-        .depth = 8
-    };
-    
-    FPCamera::ControllerConfig controllerConfig = {
-        .speed = 40.0f,
-        .sensitivity = 0.7f,
-        .rotation = glm::vec2(-90, 0)
-    };
-
-    Camera::Config cameraConfig = {
-        .position = glm::vec3((1 << (octreeConfig.depth-1)), (1 << (octreeConfig.depth-1)), (1 << (octreeConfig.depth-1)) * 3), 
-        .direction = glm::vec3(0, 0, 0),
-        .aspect_ratio = windowConfig->viewportAspectRatio,
-        .FOV = 90.0f
-    };
-
-    core::FrameConfig frameConfig = {
-        .renderType = core::RenderType::DEFAULT,
-        .lBufferSwapSeconds = 0.2,
-        .TAA = false,
-        .spp = 1,
-        .bounces = 2,
-        .controlchecks = 300,
-        .shaderRecompilation = false,
-        .renderToTexture = false
-    };
-
-
-    octree = new Octree(&octreeConfig);
-    camera = new FPCamera(&cameraConfig, &controllerConfig);
-    materialPool = new MaterialPool();
-    renderer = new Renderer(&rendererConfig, octree, camera, materialPool);
-
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    interface = new Interface(window, renderer->glsl_version);
-
-    info->SetProfilerData(&renderer->debug);
-    control->SetConfigs(&rendererConfig, &frameConfig, &controllerConfig, &cameraConfig);
-
-    {
-        Material emissive_m = {
-            .color = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f),
-            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
-            .diffuse = 0.3f,
-            .specular = 0.4f,
-            .metallic = 0.3f,
-            .emissive = true,
-            .emissiveIntensity = 4.0f
-        };
-
-        Material red_m = {
-            .color = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f),
-            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
-            .diffuse = 0.7f,
-            .specular = 0.6f,
-            .metallic = 0.3f,
-            .emissive = false,
-            .emissiveIntensity = 0.0f
-        };
-
-        Material green_m = {
-            .color = glm::vec4(0.0f, 1.0f, 0.0f, 0.0f),
-            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
-            .diffuse = 0.7f,
-            .specular = 0.6f,
-            .metallic = 0.3f,
-            .emissive = false,
-            .emissiveIntensity = 0.0f
-        };
-
-        Material white_m = {
-            .color = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f),
-            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
-            .diffuse = 0.8f,
-            .specular = 0.7f,
-            .metallic = 0.3f,
-            .emissive = false,
-            .emissiveIntensity = 0.0f
-        };
-
-        Material metallic_m = {
-            .color = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f),
-            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
-            .diffuse = 0.01f,
-            .specular = 0.9f,
-            .metallic = 0.9f,
-            .emissive = false,
-            .emissiveIntensity = 0.0f
-        };
-
-        Material specular_blue_m = {
-            .color = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f),
-            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
-            .diffuse = 0.9f,
-            .specular = 0.95f,
-            .metallic = 0.4f,
-            .emissive = false,
-            .emissiveIntensity = 0.0f
-        };
-
-        uint32_t emissive_mat = materialPool->addMaterial(&emissive_m);
-        uint32_t red_mat = materialPool->addMaterial(&red_m);
-        uint32_t green_mat = materialPool->addMaterial(&green_m);
-        uint32_t white_mat = materialPool->addMaterial(&white_m);
-        uint32_t metallic_mat = materialPool->addMaterial(&metallic_m);
-        uint32_t specular_blue_mat = materialPool->addMaterial(&specular_blue_m);
-
-        Perlin *noiseMaker = new Perlin();
-
-        uint32_t octree_length = 1 << (octree->depth-1);
-        uint32_t normal_samples = 3;
-
-        glm::vec3 spherePosition = glm::vec3((float)octree_length/3.0, (float)octree_length/3.0 - 5, (float)octree_length/2.0);
-        float sphereSize = (float)octree_length/3.0 - 10;
-
-        for(int i = 0; i < octree_length && !glfwWindowShouldClose(window); i++){
-            for(int j = 0; j < octree_length; j++){
-                for(int k = 0; k < octree_length; k++){
-                    float d = glm::distance(glm::vec3((float)i, (float)j, (float)k), spherePosition);
-                    if(d > sphereSize || d < sphereSize - 10)continue;
-
-                    glm::vec3 normal = glm::vec3(0,0,0);
-
-                    for(int a = i-normal_samples; a <= i+normal_samples; a++) 
-                    for(int b = j-normal_samples; b <= j+normal_samples; b++) 
-                    for(int c = k-normal_samples; c <= k+normal_samples; c++){
-                                if(a >= octree_length || b >= octree_length || c >= octree_length || a < 0 || b < 0 || c < 0){
-                                    normal += glm::vec3(a-i,b-j,c-k); 
-                                    continue;  
-                                }
-                                float d = glm::distance(glm::vec3((float)a, (float)b, (float)c), spherePosition);
-                                if(d > sphereSize || d < sphereSize - 10)
-                                    normal += glm::vec3(a-i,b-j,c-k);     
-                    }  
-                    normal = glm::normalize(normal);
-                    if(i == octree_length-1){
-                        normal += glm::vec3(1.0f, 0, 0);
-                    }
-                    if(j == octree_length-1){
-                        normal += glm::vec3(0, 1.0f, 0);
-                    }
-                    if(k == octree_length-1){
-                        normal += glm::vec3(0, 0, 1.0f);
-                    }
-                    if(i == 0){
-                        normal += glm::vec3(-1.0f, 0, 0);
-                    }
-                    if(j == 0){
-                        normal += glm::vec3(0, -1.0f, 0);
-                    }if(k == 0){
-                        normal += glm::vec3(0, 0, -1.0f);
-                    }
-                    if(normal.length() < 0.1f)
-                        normal = glm::vec3(1,0,0);
-                    normal = glm::normalize(normal);
-                        
-
-                    Octree::Node leaf;
-                    leaf.leaf.material = specular_blue_mat;
-                    leaf.leaf.normal = Octree::packedNormal(normal);
-                    octree->insert(glm::uvec3(i,j,k), leaf);
-                }
-            }
-        }
-
-        spherePosition = glm::vec3((float)octree_length*3.0/4.0 - 5, (float)octree_length*3/4 - 15, (float)octree_length*3/4 - 5);
-        sphereSize = octree_length/4;
-
-        for(int i = 0; i < octree_length && !glfwWindowShouldClose(window); i++){
-            for(int j = 0; j < octree_length; j++){
-                for(int k = 0; k < octree_length; k++){
-                    float d = glm::distance(glm::vec3((float)i, (float)j, (float)k), spherePosition);
-                    if(d > sphereSize || d < sphereSize - 10)continue;
-
-                    int r = (int)((noiseMaker->noise((float)i * 0.04f,(float)j * 0.03f,(float)k * 0.03f) + 1) * 5);
-                    int g = (int)((noiseMaker->noise((float)i * 0.03f,(float)j * 0.04f,(float)k * 0.03f) + 1) * 5);
-
-                    glm::vec3 normal = glm::vec3(0,0,0);
-
-                    for(int a = i-normal_samples; a <= i+normal_samples; a++) 
-                    for(int b = j-normal_samples; b <= j+normal_samples; b++) 
-                    for(int c = k-normal_samples; c <= k+normal_samples; c++){
-                                if(a >= octree_length || b >= octree_length || c >= octree_length || a < 0 || b < 0 || c < 0){
-                                    normal += glm::vec3(a-i,b-j,c-k); 
-                                    continue;  
-                                }
-                                float d = glm::distance(glm::vec3((float)a, (float)b, (float)c), spherePosition);
-                                if(d > sphereSize || d < sphereSize - 10)
-                                    normal += glm::vec3(a-i,b-j,c-k);     
-                    }  
-                    normal = glm::normalize(normal);
-                    if(i == octree_length-1){
-                        normal += glm::vec3(1.0f, 0, 0);
-                    }
-                    if(j == octree_length-1){
-                        normal += glm::vec3(0, 1.0f, 0);
-                    }
-                    if(k == octree_length-1){
-                        normal += glm::vec3(0, 0, 1.0f);
-                    }
-                    if(i == 0){
-                        normal += glm::vec3(-1.0f, 0, 0);
-                    }
-                    if(j == 0){
-                        normal += glm::vec3(0, -1.0f, 0);
-                    }if(k == 0){
-                        normal += glm::vec3(0, 0, -1.0f);
-                    }
-                    if(normal.length() < 0.1f)
-                        normal = glm::vec3(1,0,0);
-                    normal = glm::normalize(normal);
-                        
-
-                    Octree::Node leaf;
-                    if(r == 5 && g == 6)
-                        r = 3;
-                    leaf.leaf.material = white_mat;
-                    leaf.leaf.normal = Octree::packedNormal(normal);
-                    octree->insert(glm::uvec3(i,j,k), leaf);
-                }
-            }
-        }
-
-        for(int i = 0; i < octree_length; i++){
-            for(int j = 0; j < 4; j++){
-                for(int k = 0; k < octree_length; k++){
-
-                    glm::vec3 normal = glm::vec3(0,0,0);
-
-                    for(int a = i-normal_samples; a <= i+normal_samples; a++) 
-                    for(int b = j-normal_samples; b <= j+normal_samples; b++) 
-                    for(int c = k-normal_samples; c <= k+normal_samples; c++){
-                                if(a >= octree_length || b >= octree_length || c >= octree_length || a < 0 || b < 0 || c < 0){
-                                    normal += glm::vec3(a-i,b-j,c-k); 
-                                    continue;  
-                                }
-                                if(b >= 4 || b < 0)
-                                    normal += glm::vec3(a-i,b-j,c-k);     
-                    }  
-                    normal = glm::normalize(normal);
-                    if(i == octree_length-1){
-                        normal += glm::vec3(1.0f, 0, 0);
-                    }
-                    if(j == octree_length-1){
-                        normal += glm::vec3(0, 1.0f, 0);
-                    }
-                    if(k == octree_length-1){
-                        normal += glm::vec3(0, 0, 1.0f);
-                    }
-                    if(i == 0){
-                        normal += glm::vec3(-1.0f, 0, 0);
-                    }
-                    if(j == 0){
-                        normal += glm::vec3(0, -1.0f, 0);
-                    }if(k == 0){
-                        normal += glm::vec3(0, 0, -1.0f);
-                    }
-                    if(normal.length() < 0.1f)
-                        normal = glm::vec3(1,0,0);
-                    normal = glm::normalize(normal);
-                        
-
-                    Octree::Node leaf;
-                    leaf.leaf.material = white_mat;
-                    leaf.leaf.normal = Octree::packedNormal(normal);
-                    octree->insert(glm::uvec3(i,j,k), leaf);
-                }
-            }
-        }
-
-        for(int i = 0; i < 4; i++){
-            for(int j = 0; j < octree_length; j++){
-                for(int k = 0; k < octree_length; k++){
-
-                    glm::vec3 normal = glm::vec3(0,0,0);
-
-                    for(int a = i-normal_samples; a <= i+normal_samples; a++) 
-                    for(int b = j-normal_samples; b <= j+normal_samples; b++) 
-                    for(int c = k-normal_samples; c <= k+normal_samples; c++){
-                                if(a >= octree_length || b >= octree_length || c >= octree_length || a < 0 || b < 0 || c < 0){
-                                    normal += glm::vec3(a-i,b-j,c-k); 
-                                    continue;  
-                                }
-                                if(a >= 4 || a < 0)
-                                    normal += glm::vec3(a-i,b-j,c-k);     
-                    }  
-                    normal = glm::normalize(normal);
-                    if(i == octree_length-1){
-                        normal += glm::vec3(1.0f, 0, 0);
-                    }
-                    if(j == octree_length-1){
-                        normal += glm::vec3(0, 1.0f, 0);
-                    }
-                    if(k == octree_length-1){
-                        normal += glm::vec3(0, 0, 1.0f);
-                    }
-                    if(i == 0){
-                        normal += glm::vec3(-1.0f, 0, 0);
-                    }
-                    if(j == 0){
-                        normal += glm::vec3(0, -1.0f, 0);
-                    }if(k == 0){
-                        normal += glm::vec3(0, 0, -1.0f);
-                    }
-                    if(normal.length() < 0.1f)
-                        normal = glm::vec3(1,0,0);
-                    normal = glm::normalize(normal);
-                        
-
-                    Octree::Node leaf;
-                    leaf.leaf.material = green_mat;
-                    leaf.leaf.normal = Octree::packedNormal(normal);
-                    octree->insert(glm::uvec3(i,j,k), leaf);
-                }
-            }
-        }
-
-        for(int i = octree_length-4; i < octree_length; i++){
-            for(int j = 0; j < octree_length; j++){
-                for(int k = 0; k < octree_length; k++){
-
-                    glm::vec3 normal = glm::vec3(0,0,0);
-
-                    for(int a = i-normal_samples; a <= i+normal_samples; a++) 
-                    for(int b = j-normal_samples; b <= j+normal_samples; b++) 
-                    for(int c = k-normal_samples; c <= k+normal_samples; c++){
-                                if(a >= octree_length || b >= octree_length || c >= octree_length || a < 0 || b < 0 || c < 0){
-                                    normal += glm::vec3(a-i,b-j,c-k); 
-                                    continue;  
-                                }
-                                if(a < octree_length-4 || a >= octree_length)
-                                    normal += glm::vec3(a-i,b-j,c-k);     
-                    }  
-                    normal = glm::normalize(normal);
-                    if(i == octree_length-1){
-                        normal += glm::vec3(1.0f, 0, 0);
-                    }
-                    if(j == octree_length-1){
-                        normal += glm::vec3(0, 1.0f, 0);
-                    }
-                    if(k == octree_length-1){
-                        normal += glm::vec3(0, 0, 1.0f);
-                    }
-                    if(i == 0){
-                        normal += glm::vec3(-1.0f, 0, 0);
-                    }
-                    if(j == 0){
-                        normal += glm::vec3(0, -1.0f, 0);
-                    }if(k == 0){
-                        normal += glm::vec3(0, 0, -1.0f);
-                    }
-                    if(normal.length() < 0.1f)
-                        normal = glm::vec3(1,0,0);
-                    normal = glm::normalize(normal);
-                        
-
-                    Octree::Node leaf;
-                    leaf.leaf.material = red_mat;
-                    leaf.leaf.normal = Octree::packedNormal(normal);
-                    octree->insert(glm::uvec3(i,j,k), leaf);
-                }
-            }
-        }
-
-        for(int i = 0; i < octree_length; i++){
-            for(int j = 0; j < octree_length; j++){
-                for(int k = 0; k < 4; k++){
-                    int r = (int)((noiseMaker->noise((float)i * 0.04f,(float)j * 0.03f,(float)k * 0.03f) + 1) * 5);
-                    int g = (int)((noiseMaker->noise((float)i * 0.03f,(float)j * 0.04f,(float)k * 0.03f) + 1) * 5);
-
-                    glm::vec3 normal = glm::vec3(0,0,0);
-
-                    for(int a = i-normal_samples; a <= i+normal_samples; a++) 
-                    for(int b = j-normal_samples; b <= j+normal_samples; b++) 
-                    for(int c = k-normal_samples; c <= k+normal_samples; c++){
-                                if(a >= octree_length || b >= octree_length || c >= octree_length || a < 0 || b < 0 || c < 0){
-                                    normal += glm::vec3(a-i,b-j,c-k); 
-                                    continue;  
-                                }
-                                if(c >= 4 || c < 0)
-                                    normal += glm::vec3(a-i,b-j,c-k);     
-                    }  
-                    normal = glm::normalize(normal);
-                    if(i == octree_length-1){
-                        normal += glm::vec3(1.0f, 0, 0);
-                    }
-                    if(j == octree_length-1){
-                        normal += glm::vec3(0, 1.0f, 0);
-                    }
-                    if(k == octree_length-1){
-                        normal += glm::vec3(0, 0, 1.0f);
-                    }
-                    if(i == 0){
-                        normal += glm::vec3(-1.0f, 0, 0);
-                    }
-                    if(j == 0){
-                        normal += glm::vec3(0, -1.0f, 0);
-                    }if(k == 0){
-                        normal += glm::vec3(0, 0, -1.0f);
-                    }
-                    if(normal.length() < 0.1f)
-                        normal = glm::vec3(1,0,0);
-                    normal = glm::normalize(normal);
-                        
-
-                    Octree::Node leaf;
-                    leaf.leaf.material = metallic_mat;
-                    leaf.leaf.normal = Octree::packedNormal(normal);
-                    octree->insert(glm::uvec3(i,j,k), leaf);
-                }
-            }
-        }
-
-        /*for(int i = 0; i < octree_length; i++){
-            for(int j = 0; j < octree_length; j++){
-                for(int k = octree_length-5; k < octree_length; k++){
-                    int r = (int)((noiseMaker->noise((float)i * 0.04f,(float)j * 0.03f,(float)k * 0.03f) + 1) * 5);
-                    int g = (int)((noiseMaker->noise((float)i * 0.03f,(float)j * 0.04f,(float)k * 0.03f) + 1) * 5);
-
-                    glm::vec3 normal = glm::vec3(0,0,0);
-
-                    for(int a = i-normal_samples; a <= i+normal_samples; a++) 
-                    for(int b = j-normal_samples; b <= j+normal_samples; b++) 
-                    for(int c = k-normal_samples; c <= k+normal_samples; c++){
-                                if(a >= octree_length || b >= octree_length || c >= octree_length || a < 0 || b < 0 || c < 0){
-                                    normal += glm::vec3(a-i,b-j,c-k); 
-                                    continue;  
-                                }
-                                if(c < octree_length-5 || c >= octree_length)
-                                    normal += glm::vec3(a-i,b-j,c-k);     
-                    }  
-                    normal = glm::normalize(normal);
-                    if(i == octree_length-1){
-                        normal += glm::vec3(1.0f, 0, 0);
-                    }
-                    if(j == octree_length-1){
-                        normal += glm::vec3(0, 1.0f, 0);
-                    }
-                    if(k == octree_length-1){
-                        normal += glm::vec3(0, 0, 1.0f);
-                    }
-                    if(i == 0){
-                        normal += glm::vec3(-1.0f, 0, 0);
-                    }
-                    if(j == 0){
-                        normal += glm::vec3(0, -1.0f, 0);
-                    }if(k == 0){
-                        normal += glm::vec3(0, 0, -1.0f);
-                    }
-                    if(normal.length() < 0.1f)
-                        normal = glm::vec3(1,0,0);
-                    normal = glm::normalize(normal);
-                        
-
-                    Octree::Node leaf;
-                    leaf.leaf.material = metallic_mat;
-                    leaf.leaf.normal = Octree::packedNormal(normal);
-                    octree->insert(glm::uvec3(i,j,k), leaf);
-                }
-            }
-        }*/
-
-        for(int i = 0; i < octree_length; i++){
-            for(int j = octree_length-4; j < octree_length; j++){
-                for(int k = 0; k < octree_length; k++){
-
-                    glm::vec3 normal = glm::vec3(0,0,0);
-
-                    for(int a = i-normal_samples; a <= i+normal_samples; a++) 
-                    for(int b = j-normal_samples; b <= j+normal_samples; b++) 
-                    for(int c = k-normal_samples; c <= k+normal_samples; c++){
-                                if(a >= octree_length || b >= octree_length || c >= octree_length || a < 0 || b < 0 || c < 0){
-                                    normal += glm::vec3(a-i,b-j,c-k); 
-                                    continue;  
-                                }
-                                if(b < octree_length-4 || b >= octree_length)
-                                    normal += glm::vec3(a-i,b-j,c-k);     
-                    }  
-                    normal = glm::normalize(normal);
-                    if(i == octree_length-1){
-                        normal += glm::vec3(1.0f, 0, 0);
-                    }
-                    if(j == octree_length-1){
-                        normal += glm::vec3(0, 1.0f, 0);
-                    }
-                    if(k == octree_length-1){
-                        normal += glm::vec3(0, 0, 1.0f);
-                    }
-                    if(i == 0){
-                        normal += glm::vec3(-1.0f, 0, 0);
-                    }
-                    if(j == 0){
-                        normal += glm::vec3(0, -1.0f, 0);
-                    }if(k == 0){
-                        normal += glm::vec3(0, 0, -1.0f);
-                    }
-                    if(normal.length() < 0.1f)
-                        normal = glm::vec3(1,0,0);
-                    normal = glm::normalize(normal);
-                        
-
-                    Octree::Node leaf;
-                    leaf.leaf.material = white_mat;
-                    leaf.leaf.normal = Octree::packedNormal(normal);
-                    octree->insert(glm::uvec3(i,j,k), leaf);
-                }
-            }
-        }
-
-        for(int i = octree_length/4; i < octree_length*3/4; i++){
-            for(int j = octree_length-8; j < octree_length-4; j++){
-                for(int k = octree_length/4; k < octree_length*3/4; k++){
-
-                    glm::vec3 normal = glm::vec3(0,0,0);
-
-                    for(int a = i-normal_samples; a <= i+normal_samples; a++) 
-                    for(int b = j-normal_samples; b <= j+normal_samples; b++) 
-                    for(int c = k-normal_samples; c <= k+normal_samples; c++){
-                                if(a >= octree_length || b >= octree_length || c >= octree_length || a < 0 || b < 0 || c < 0){
-                                    normal += glm::vec3(a-i,b-j,c-k); 
-                                    continue;  
-                                }
-                                if(b < octree_length-8 || b >= octree_length-4)
-                                    normal += glm::vec3(a-i,b-j,c-k);     
-                    }  
-                    normal = glm::normalize(normal);
-                    if(i == octree_length-1){
-                        normal += glm::vec3(1.0f, 0, 0);
-                    }
-                    if(j == octree_length-1){
-                        normal += glm::vec3(0, 1.0f, 0);
-                    }
-                    if(k == octree_length-1){
-                        normal += glm::vec3(0, 0, 1.0f);
-                    }
-                    if(i == 0){
-                        normal += glm::vec3(-1.0f, 0, 0);
-                    }
-                    if(j == 0){
-                        normal += glm::vec3(0, -1.0f, 0);
-                    }if(k == 0){
-                        normal += glm::vec3(0, 0, -1.0f);
-                    }
-                    if(normal.length() < 0.1f)
-                        normal = glm::vec3(1,0,0);
-                    normal = glm::normalize(normal);
-                        
-
-                    Octree::Node leaf;
-                    leaf.leaf.material = emissive_mat;
-                    leaf.leaf.normal = Octree::packedNormal(normal);
-                    octree->insert(glm::uvec3(i,j,k), leaf);
-                }
-            }
-        }
-
-        delete noiseMaker;
-    }
-
-    renderer->debug.start_ms = glfwGetTime()*1000.0;
-    renderer->debug.end_ms = glfwGetTime()*1000.0;
-
-    while(!glfwWindowShouldClose(window)){
-        glfwPollEvents();
-
-
-        if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS){
-            ui_active = true;
-            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-        }
-        if(glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS && !interface->io.WantCaptureMouse && !interface->io.WantCaptureKeyboard){
-            ui_active = false;
-            camera->firstFrame = true;
-            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-        }
-        if(!ui_active)
-            frameConfig.TAA = !camera->GLFWInput(window);
-
-        if(ui_active){
-            Widget *widgets[2] = {info, control};
-            interface->Draw(widgets, 2);
-        }else{
-            Widget *widgets[0] = {};
-            interface->Draw(widgets, 0);
-        }
-        
-
-        if(!renderer->run(&frameConfig))
-            break;
-
-        interface->Render();
-
-        glfwSwapBuffers(window);
-    }
-
-    delete info;
-}
-
-VoxelEngine::~VoxelEngine(){
-    delete camera;
-    delete octree;
-    delete materialPool;
-
-    delete interface;
-    glfwDestroyWindow(window);
-    glfwTerminate();
-    delete renderer;
-}
-
-void VoxelEngine::setupContext(const Config *windowConfig){
-    glfwSetErrorCallback(glfw_error_callback);
-    if (!glfwInit())
-        return;
-
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-    
-    window = glfwCreateWindow(windowConfig->windowSize.x, windowConfig->windowSize.y, windowConfig->windowName, nullptr, nullptr);
-    if (window == nullptr)
-        return;
-
-    glfwMakeContextCurrent(window);
-    gladLoadGL();
-    glfwSwapInterval(0);
-}
-
-void VoxelEngine::glfw_error_callback(int error, const char* description){
-    printf("GLFW Error %d: %s\n", error, description);
+#include "voxelengine.hpp"
+#include "Noise/FractalNoise.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <ctime>
+#include <random>
+
+#define SCENE_COMMIT_MS 4.0 //main thread time per frame spent inserting finished scene chunks
+#define TRACE_SECONDS 10.0  //history written by the trace hotkey
+#define CAPTURE_FPS 60      //playback rate of captured video outside of benchmarks
+#define QUERY_RAYS (1 << 18)    //short CPU rays timed over the built scene when debugging
+#define QUERY_RAY_LENGTH 16.0f  //in leaves, about a picking or line of sight distance
+
+//solid leaves of one block, normals point away from the empty cells around each leaf
+static void shapeLeaves(Octree *octree, glm::uvec3 blockMin, glm::uvec3 blockMax, uint32_t material, const std::function<bool(glm::ivec3)> &solid, std::vector<std::pair<glm::uvec3, Octree::Node>> &leaves){
+    PROFILE_ZONE("scene chunk");
+    int octree_length = 1 << (octree->depth-1);
+    int normal_samples = 3;
+
+    for(int i = blockMin.x; i < (int)blockMax.x; i++){
+        for(int j = blockMin.y; j < (int)blockMax.y; j++){
+            for(int k = blockMin.z; k < (int)blockMax.z; k++){
+                if(!solid(glm::ivec3(i,j,k)))continue;
+
+                glm::vec3 normal = glm::vec3(0,0,0);
+
+                for(int a = i-normal_samples; a <= i+normal_samples; a++) 
+                for(int b = j-normal_samples; b <= j+normal_samples; b++) 
+                for(int c = k-normal_samples; c <= k+normal_samples; c++){
+                            if(a >= octree_length || b >= octree_length || c >= octree_length || a < 0 || b < 0 || c < 0){
+                                normal += glm::vec3(a-i,b-j,c-k); 
+                                continue;  
+                            }
+                            if(!solid(glm::ivec3(a,b,c)))
+                                normal += glm::vec3(a-i,b-j,c-k);     
+                }  
+                normal = glm::normalize(normal);
+                if(i == octree_length-1){
+                    normal += glm::vec3(1.0f, 0, 0);
+                }
+                if(j == octree_length-1){
+                    normal += glm::vec3(0, 1.0f, 0);
+                }
+                if(k == octree_length-1){
+                    normal += glm::vec3(0, 0, 1.0f);
+                }
+                if(i == 0){
+                    normal += glm::vec3(-1.0f, 0, 0);
+                }
+                if(j == 0){
+                    normal += glm::vec3(0, -1.0f, 0);
+                }if(k == 0){
+                    normal += glm::vec3(0, 0, -1.0f);
+                }
+                if(normal.length() < 0.1f)
+                    normal = glm::vec3(1,0,0);
+                normal = glm::normalize(normal);
+
+                Octree::Node leaf;
+                leaf.raw = 0;
+                leaf.leaf.material = material;
+                leaf.leaf.normal = Octree::packedNormal(normal);
+                leaves.push_back({glm::uvec3(i,j,k), leaf});
+            }
+        }
+    }
+}
+
+//splits the shape into chunks built by the job system, they are inserted in queue order by commitScene
+void VoxelEngine::queueShape(Octree *target, glm::ivec3 min, glm::ivec3 max, uint32_t material, std::function<bool(glm::ivec3)> solid){
+    std::shared_ptr<std::function<bool(glm::ivec3)>> shape = std::make_shared<std::function<bool(glm::ivec3)>>(std::move(solid));
+    glm::uvec3 grain = glm::uvec3(16);
+    for(uint32_t i = min.x; i < (uint32_t)max.x; i += grain.x){
+        for(uint32_t j = min.y; j < (uint32_t)max.y; j += grain.y){
+            for(uint32_t k = min.z; k < (uint32_t)max.z; k += grain.z){
+                sceneChunks.emplace_back();
+                SceneChunk *chunk = &sceneChunks.back();
+                chunk->target = target;
+                glm::uvec3 blockMin = glm::uvec3(i, j, k), blockMax = glm::min(blockMin + grain, glm::uvec3(max));
+                chunk->job = jobs->run([chunk, shape, blockMin, blockMax, material](){
+                    shapeLeaves(chunk->target, blockMin, blockMax, material, *shape, chunk->leaves);
+                });
+            }
+        }
+    }
+}
+
+//inserts finished chunks in queue order for at most budgetMs, returns false once everything is in the octrees
+bool VoxelEngine::commitScene(double budgetMs){
+    PROFILE_ZONE("VoxelEngine::commitScene");
+    double start = glfwGetTime();
+    while(committedChunks < sceneChunks.size()){
+        SceneChunk &chunk = sceneChunks[committedChunks];
+        if(!jobs->finished(chunk.job))
+            return true;
+
+        while(chunk.committed < chunk.leaves.size()){
+            chunk.target->insert(chunk.leaves[chunk.committed].first, chunk.leaves[chunk.committed].second);
+            chunk.committed++;
+            if((chunk.committed & 255) == 0 && (glfwGetTime() - start) * 1000.0 > budgetMs)
+                return true;
+        }
+        std::vector<std::pair<glm::uvec3, Octree::Node>>().swap(chunk.leaves);
+        committedChunks++;
+    }
+    return false;
+}
+
+//random short rays inside the scene through raycastBatch, the throughput picking and collision queries can count on
+void VoxelEngine::timeQueries(const core::RendererConfig &config){
+    float length = (float)(1 << (octree->depth-1));
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<Octree::Ray> rays(QUERY_RAYS);
+    for(Octree::Ray &ray : rays){
+        glm::vec3 direction(unit(random) - 0.5f, unit(random) - 0.5f, unit(random) - 0.5f);
+        ray.origin = glm::vec3(unit(random), unit(random), unit(random)) * length;
+        ray.direction = glm::length(direction) > 0.001f ? glm::normalize(direction) : glm::vec3(0, 1, 0);
+        ray.maxDistance = QUERY_RAY_LENGTH;
+    }
+
+    std::vector<Octree::RayHit> hits(rays.size());
+    double start = glfwGetTime();
+    octree->raycastBatch(jobs, rays.data(), hits.data(), rays.size());
+    double seconds = glfwGetTime() - start;
+    size_t hit = std::count_if(hits.begin(), hits.end(), [](const Octree::RayHit &h){ return h.hit; });
+    config.logMessage("[%f] raycastBatch: %zu rays of %.0f leaves in %f ms, %.2f M rays/s, %zu hits \n", glfwGetTime(),
+        rays.size(), QUERY_RAY_LENGTH, seconds * 1000.0, (double)rays.size() / seconds / 1e6, hit);
+}
+
+VoxelEngine::VoxelEngine(const Config *windowConfig){
+    Profiler::setThreadName("main");
+    setupContext(windowConfig);
+    double startupStart = glfwGetTime();
+    jobs = new JobSystem({ .threads = 0 });
+
+    Info *info = new Info("info");
+    Control *control = new Control("control");
+
+    auto logMessage = [&info](const char* format, va_list args) {
+        info->vAddLog(format, args);
+        vprintf(format, args);
+    };
+
+    auto fbSize = [this](){
+        glm::ivec2 size; 
+        glfwGetFramebufferSize(window, &size.x, &size.y); 
+        return size;
+    };
+
+    core::RendererConfig rendererConfig = {
+        .log = logMessage,
+        .framebufferSize = fbSize,
+        .aspectRatio = windowConfig->viewportAspectRatio,
+        .debuggingEnabled = false
+    };
+
+    Octree::Config octreeConfig = {
+        .depth = 8
+    };
+    
+    FPCamera::ControllerConfig controllerConfig = {
+        .speed = 40.0f,
+        .sensitivity = 0.7f,
+        .rotation = glm::vec2(-90, 0)
+    };
+
+    Camera::Config cameraConfig = {
+        .position = glm::vec3((1 << (octreeConfig.depth-1)), (1 << (octreeConfig.depth-1)), (1 << (octreeConfig.depth-1)) * 3), 
+        .direction = glm::vec3(0, 0, 0),
+        .aspect_ratio = windowConfig->viewportAspectRatio,
+        .FOV = 90.0f
+    };
+
+    core::FrameConfig frameConfig = {
+        .renderType = core::RenderType::DEFAULT,
+        .lBufferSwapSeconds = 0.2,
+        .TAA = false,
+        .spp = 1,
+        .bounces = 2,
+        .controlchecks = 300,
+        .shaderRecompilation = false,
+        .renderToTexture = false
+    };
+
+
+    octree = new Octree(&octreeConfig);
+    camera = new FPCamera(&cameraConfig, &controllerConfig);
+    materialPool = new MaterialPool();
+    instances = new InstanceScene();
+    renderer = new Renderer(&rendererConfig, octree, camera, materialPool, instances, jobs);
+
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    interface = new Interface(window, renderer->glsl_version);
+
+    info->SetProfilerData(&renderer->debug);
+    control->SetConfigs(&rendererConfig, &frameConfig, &controllerConfig, &cameraConfig);
+
+    {
+        Material emissive_m = {
+            .color = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f),
+            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
+            .diffuse = 0.3f,
+            .specular = 0.4f,
+            .metallic = 0.3f,
+            .emissive = true,
+            .emissiveIntensity = 4.0f
+        };
+
+        Material red_m = {
+            .color = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f),
+            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
+            .diffuse = 0.7f,
+            .specular = 0.6f,
+            .metallic = 0.3f,
+            .emissive = false,
+            .emissiveIntensity = 0.0f
+        };
+
+        Material green_m = {
+            .color = glm::vec4(0.0f, 1.0f, 0.0f, 0.0f),
+            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
+            .diffuse = 0.7f,
+            .specular = 0.6f,
+            .metallic = 0.3f,
+            .emissive = false,
+            .emissiveIntensity = 0.0f
+        };
+
+        Material white_m = {
+            .color = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f),
+            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
+            .diffuse = 0.8f,
+            .specular = 0.7f,
+            .metallic = 0.3f,
+            .emissive = false,
+            .emissiveIntensity = 0.0f
+        };
+
+        Material metallic_m = {
+            .color = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f),
+            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
+            .diffuse = 0.01f,
+            .specular = 0.9f,
+            .metallic = 0.9f,
+            .emissive = false,
+            .emissiveIntensity = 0.0f
+        };
+
+        Material specular_blue_m = {
+            .color = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f),
+            .specularColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
+            .diffuse = 0.9f,
+            .specular = 0.95f,
+            .metallic = 0.4f,
+            .emissive = false,
+            .emissiveIntensity = 0.0f
+        };
+
+        uint32_t emissive_mat = materialPool->addMaterial(&emissive_m);
+        uint32_t red_mat = materialPool->addMaterial(&red_m);
+        uint32_t green_mat = materialPool->addMaterial(&green_m);
+        uint32_t white_mat = materialPool->addMaterial(&white_m);
+        uint32_t metallic_mat = materialPool->addMaterial(&metallic_m);
+        uint32_t specular_blue_mat = materialPool->addMaterial(&specular_blue_m);
+
+        int octree_length = 1 << (octree->depth-1);
+
+        glm::vec3 spherePosition = glm::vec3((float)octree_length/3.0, (float)octree_length/3.0 - 5, (float)octree_length/2.0);
+        float sphereSize = (float)octree_length/3.0 - 10;
+        queueShape(octree, glm::ivec3(0), glm::ivec3(octree_length), specular_blue_mat, [=](glm::ivec3 p){
+            float d = glm::distance(glm::vec3(p), spherePosition);
+            return d <= sphereSize && d >= sphereSize - 10;
+        });
+
+        glm::vec3 spherePosition2 = glm::vec3((float)octree_length*3.0/4.0 - 5, (float)octree_length*3/4 - 15, (float)octree_length*3/4 - 5);
+        float sphereSize2 = octree_length/4;
+        queueShape(octree, glm::ivec3(0), glm::ivec3(octree_length), white_mat, [=](glm::ivec3 p){
+            float d = glm::distance(glm::vec3(p), spherePosition2);
+            return d <= sphereSize2 && d >= sphereSize2 - 10;
+        });
+
+        //walls, floor and ceiling
+        queueShape(octree, glm::ivec3(0), glm::ivec3(octree_length, 4, octree_length), white_mat, [](glm::ivec3 p){ return p.y >= 0 && p.y < 4; });
+        queueShape(octree, glm::ivec3(0), glm::ivec3(4, octree_length, octree_length), green_mat, [](glm::ivec3 p){ return p.x >= 0 && p.x < 4; });
+        queueShape(octree, glm::ivec3(octree_length-4, 0, 0), glm::ivec3(octree_length), red_mat, [=](glm::ivec3 p){ return p.x >= octree_length-4 && p.x < octree_length; });
+        queueShape(octree, glm::ivec3(0), glm::ivec3(octree_length, octree_length, 4), metallic_mat, [](glm::ivec3 p){ return p.z >= 0 && p.z < 4; });
+        //queueShape(octree, glm::ivec3(0, 0, octree_length-5), glm::ivec3(octree_length), metallic_mat, [=](glm::ivec3 p){ return p.z >= octree_length-5 && p.z < octree_length; });
+        queueShape(octree, glm::ivec3(0, octree_length-4, 0), glm::ivec3(octree_length), white_mat, [=](glm::ivec3 p){ return p.y >= octree_length-4 && p.y < octree_length; });
+
+        //ceiling light
+        queueShape(octree, glm::ivec3(octree_length/4, octree_length-8, octree_length/4), glm::ivec3(octree_length*3/4, octree_length-4, octree_length*3/4), emissive_mat, [=](glm::ivec3 p){
+            return p.y >= octree_length-8 && p.y < octree_length-4;
+        });
+
+        //props placed by transform, the model voxels are stored once for every copy
+        prop = new Octree(new Octree::Config{ .depth = 5 });
+        uint32_t prop_length = 12;
+        glm::vec3 propCenter = glm::vec3((float)prop_length / 2.0f);
+        for(uint32_t i = 0; i < prop_length; i++){
+            for(uint32_t j = 0; j < prop_length; j++){
+                for(uint32_t k = 0; k < prop_length; k++){
+                    bool shell = i == 0 || j == 0 || k == 0 || i == prop_length-1 || j == prop_length-1 || k == prop_length-1;
+                    if(!shell)continue;
+
+                    glm::vec3 normal = glm::normalize(glm::vec3((float)i, (float)j, (float)k) + glm::vec3(0.5f) - propCenter);
+
+                    Octree::Node leaf;
+                    leaf.raw = 0;
+                    leaf.leaf.material = red_mat;
+                    leaf.leaf.normal = Octree::packedNormal(normal);
+                    prop->insert(glm::uvec3(i,j,k), leaf);
+                }
+            }
+        }
+
+        uint32_t prop_model = instances->addModel(prop);
+        for(int n = 0; n < 6; n++){
+            glm::vec3 position = glm::vec3((float)octree_length * (0.15f + 0.12f * n), 4.0f + propCenter.y, (float)octree_length * 0.8f);
+            glm::mat4 transform = glm::translate(glm::mat4(1.0f), position);
+            transform = glm::rotate(transform, (float)n * 0.3f, glm::vec3(0.0f, 1.0f, 0.0f));
+            transform = glm::translate(transform, -propCenter);
+            instances->addInstance(prop_model, transform);
+        }
+
+    }
+
+    renderer->debug.startup_ms = (glfwGetTime() - startupStart) * 1000.0;
+    bool building = true;
+    bool tracePressed = false, recordPressed = false, screenshotPressed = false, videoPressed = false;
+    double busySeconds = 0.0, profiledAt = startupStart;
+
+    //the path preset replaces the frame config, the camera only moves along the path once the scene is built
+    if(windowConfig->benchmarkPath){
+        CameraPath path;
+        if(path.load(windowConfig->benchmarkPath, frameConfig)){
+            benchmark = new Benchmark(path);
+            frameConfig = path.preset;
+            rendererConfig.logMessage("[%f] benchmark %s: %zu keys, %f s at %f s per frame \n", glfwGetTime(), windowConfig->benchmarkPath, path.keys.size(), path.duration(), path.timeStep);
+        }else{
+            rendererConfig.logMessage("[%f] could not load the camera path %s \n", glfwGetTime(), windowConfig->benchmarkPath);
+        }
+    }
+    double frameStart = glfwGetTime();
+
+    renderer->debug.start_ms = glfwGetTime()*1000.0;
+    renderer->debug.end_ms = glfwGetTime()*1000.0;
+
+    while(!glfwWindowShouldClose(window)){
+        //once the progressive image has converged there is nothing left to trace, so sleep until input arrives
+        if(renderer->debug.converged && !building && !benchmark)
+            glfwWaitEventsTimeout(frameConfig.idleWaitSeconds);
+        else
+            glfwPollEvents();
+
+
+        if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS){
+            ui_active = true;
+            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+        }
+        if(glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS && !interface->io.WantCaptureMouse && !interface->io.WantCaptureKeyboard){
+            ui_active = false;
+            camera->firstFrame = true;
+            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+        }
+        if(!ui_active && !benchmark)
+            frameConfig.TAA = !camera->GLFWInput(window);
+
+        //F8 starts and stops capturing the session as a camera path
+        bool record = glfwGetKey(window, GLFW_KEY_F8) == GLFW_PRESS;
+        if(record && !recordPressed){
+            if(!recording){
+                recording = new CameraPath();
+                recording->preset = frameConfig;
+                recordStart = glfwGetTime();
+                rendererConfig.logMessage("[%f] recording camera path \n", glfwGetTime());
+            }else{
+                //one key per frame, replayed at the average frame interval
+                if(recording->keys.size() > 1)
+                    recording->timeStep = recording->duration() / (double)(recording->keys.size() - 1);
+                char path[64];
+                snprintf(path, sizeof(path), "./path_%lld.txt", (long long)time(nullptr));
+                if(!recording->keys.empty() && recording->save(path))
+                    rendererConfig.logMessage("[%f] saved %zu camera keys to %s \n", glfwGetTime(), recording->keys.size(), path);
+                else
+                    rendererConfig.logMessage("[%f] could not write %s \n", glfwGetTime(), path);
+                delete recording;
+                recording = nullptr;
+            }
+        }
+        recordPressed = record;
+        if(recording)
+            recording->keys.push_back({glfwGetTime() - recordStart, camera->position, camera->direction});
+
+        //chrome://tracing or ui.perfetto.dev open the dump
+        bool trace = glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS;
+        if(trace && !tracePressed){
+            char path[64];
+            snprintf(path, sizeof(path), "./trace_%lld.json", (long long)time(nullptr));
+            if(Profiler::dump(path, TRACE_SECONDS))
+                rendererConfig.logMessage("[%f] saved the last %.0f seconds of profiler zones to %s \n", glfwGetTime(), TRACE_SECONDS, path);
+            else
+                rendererConfig.logMessage("[%f] could not write %s \n", glfwGetTime(), path);
+        }
+        tracePressed = trace;
+
+        //F10 saves the next frame, F11 starts and stops recording every frame
+        bool screenshot = glfwGetKey(window, GLFW_KEY_F10) == GLFW_PRESS;
+        if(screenshot && !screenshotPressed){
+            char path[64];
+            snprintf(path, sizeof(path), "./screenshot_%lld.png", (long long)time(nullptr));
+            renderer->capture->screenshot(path);
+        }
+        screenshotPressed = screenshot;
+
+        bool video = glfwGetKey(window, GLFW_KEY_F11) == GLFW_PRESS;
+        if(video && !videoPressed){
+            if(!renderer->capture->recording()){
+                //benchmarks advance the camera a fixed step per frame, so the video plays back in real time
+                uint32_t fps = benchmark ? (uint32_t)std::lround(1.0 / benchmark->path.timeStep) : CAPTURE_FPS;
+                char path[64];
+                snprintf(path, sizeof(path), "./video_%lld.y4m", (long long)time(nullptr));
+                if(renderer->capture->startVideo(path, fps))
+                    rendererConfig.logMessage("[%f] recording video to %s at %u fps \n", glfwGetTime(), path, fps);
+                else
+                    rendererConfig.logMessage("[%f] could not write %s \n", glfwGetTime(), path);
+            }else{
+                renderer->capture->stopVideo();
+                rendererConfig.logMessage("[%f] video stopped, %llu frames captured so far, %llu dropped \n", glfwGetTime(),
+                    (unsigned long long)renderer->capture->stats.frames, (unsigned long long)renderer->capture->stats.dropped);
+            }
+        }
+        videoPressed = video;
+
+        {
+            PROFILE_ZONE("UI");
+            if(ui_active){
+                Widget *widgets[2] = {info, control};
+                interface->Draw(widgets, 2);
+            }else{
+                Widget *widgets[0] = {};
+                interface->Draw(widgets, 0);
+            }
+        }
+
+        //GL work handed over by jobs
+        jobs->drainMain();
+        double frameSeconds = glfwGetTime() - profiledAt;
+        profiledAt += frameSeconds;
+        jobs->profile(renderer->debug);
+        Profiler::frame(renderer->debug.zone_ms);
+
+        //the scene shows up chunk by chunk, occlusion is baked once over all of it when the last one is in
+        //generated normals are analytic, only later edits need them recomputed
+        bool bakeOcclusion = frameConfig.bakeOcclusion;
+        bool recomputeNormals = frameConfig.recomputeNormals;
+        //a compaction would be thrown away by the next chunk, it is held back until the scene is in
+        bool compactOctree = frameConfig.compactOctree;
+        bool held = building;
+        if(building){
+            for(float utilization : renderer->debug.worker_utilization)
+                busySeconds += utilization * frameSeconds;
+            building = commitScene(SCENE_COMMIT_MS);
+            renderer->debug.scene_progress = sceneChunks.empty() ? 1.0f : (float)committedChunks / (float)sceneChunks.size();
+            renderer->debug.scene_ms = (glfwGetTime() - startupStart) * 1000.0;
+            renderer->debug.scene_utilization = (float)(busySeconds / (renderer->debug.scene_ms / 1000.0) / (double)jobs->threads);
+            frameConfig.bakeOcclusion = false;
+            frameConfig.recomputeNormals = false;
+            frameConfig.compactOctree = false;
+            if(!building && rendererConfig.debuggingEnabled){
+                rendererConfig.logMessage("[%f] scene built, %u voxels \n", glfwGetTime(), octree->numVoxels);
+                timeQueries(rendererConfig);
+            }
+        }
+
+        if(benchmark && !building && !benchmark->step(camera)){
+            std::string report = benchmark->report();
+            rendererConfig.logMessage("[%f] benchmark done \n%s", glfwGetTime(), report.c_str());
+            const char *csv = windowConfig->benchmarkCsv ? windowConfig->benchmarkCsv : "./benchmark.csv";
+            if(!benchmark->writeCsv(csv))
+                rendererConfig.logMessage("[%f] could not write %s \n", glfwGetTime(), csv);
+            break;
+        }
+        if(benchmark && !building)
+            frameConfig.clock = benchmark->clock();
+
+        double runStart = glfwGetTime();
+        bool running = renderer->run(&frameConfig);
+        double runMs = (glfwGetTime() - runStart) * 1000.0;
+        frameConfig.bakeOcclusion = bakeOcclusion;
+        frameConfig.recomputeNormals = recomputeNormals;
+        if(held)
+            frameConfig.compactOctree = compactOctree;
+        if(!running)
+            break;
+
+        {
+            PROFILE_ZONE("UI render");
+            interface->Render();
+        }
+
+        glfwSwapBuffers(window);
+
+        double frameEnd = glfwGetTime();
+        if(benchmark && !building)
+            benchmark->record(renderer->debug, (frameEnd - frameStart) * 1000.0, runMs);
+        frameStart = frameEnd;
+    }
+
+    delete info;
+}
+
+VoxelEngine::~VoxelEngine(){
+    //closing the window mid build leaves chunk jobs writing into sceneChunks
+    for(SceneChunk &chunk : sceneChunks)
+        jobs->wait(chunk.job);
+    //the renderer frees what it uploaded of the scene and joins the shader compile thread, both need the context alive
+    delete renderer;
+
+    delete benchmark;
+    delete recording;
+    delete camera;
+    delete octree;
+    delete instances;
+    delete prop;
+    delete materialPool;
+
+    delete interface;
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    delete jobs;
+}
+
+void VoxelEngine::setupContext(const Config *windowConfig){
+    glfwSetErrorCallback(glfw_error_callback);
+    if (!glfwInit())
+        return;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+    
+    window = glfwCreateWindow(windowConfig->windowSize.x, windowConfig->windowSize.y, windowConfig->windowName, nullptr, nullptr);
+    if (window == nullptr)
+        return;
+
+    glfwMakeContextCurrent(window);
+    gladLoadGL();
+    glfwSwapInterval(0);
+}
+
+void VoxelEngine::glfw_error_callback(int error, const char* description){
+    printf("GLFW Error %d: %s\n", error, description);
 } 
\ No newline at end of file
@@ -1,34 +1,58 @@
-#pragma once
-
-#include "./renderer/renderer.hpp"
-#include "./UI/interface.hpp"
-#include "./UI/logger.hpp"
-#include "./UI/info.hpp"
-#include "./UI/control.hpp"
-#include "./UI/viewportWidget.hpp"
-#include "fpcamera.hpp"
-
-class VoxelEngine{
-    public:
-        struct Config{
-            glm::ivec2 windowSize;
-            float viewportAspectRatio;
-            const char* windowName;
-        };
-    public:
-        VoxelEngine(const Config *windowConfig);
-        ~VoxelEngine();
-
-        void setupContext(const Config *windowConfig);
-        void static glfw_error_callback(int error, const char* description);
-    private:    
-        GLFWwindow *window;
-        Renderer *renderer;
-
-        FPCamera *camera;
-        Octree *octree;
-        MaterialPool *materialPool;
-        Interface *interface;
-
-        bool ui_active = true;
+#pragma once
+
+#include "./renderer/renderer.hpp"
+#include "./UI/interface.hpp"
+#include "./UI/logger.hpp"
+#include "./UI/info.hpp"
+#include "./UI/control.hpp"
+#include "./UI/viewportWidget.hpp"
+#include "fpcamera.hpp"
+#include "benchmark.hpp"
+
+class VoxelEngine{
+    public:
+        struct Config{
+            glm::ivec2 windowSize;
+            float viewportAspectRatio;
+            const char* windowName;
+            const char* benchmarkPath = nullptr;    //camera path flown at a fixed time step, the engine exits when it ends
+            const char* benchmarkCsv = nullptr;     //per frame timings of the benchmark
+        };
+    public:
+        VoxelEngine(const Config *windowConfig);
+        ~VoxelEngine();
+
+        void setupContext(const Config *windowConfig);
+        void static glfw_error_callback(int error, const char* description);
+    private:
+        //a block of leaves built by a job, inserted on the main thread once finished
+        struct SceneChunk{
+            Octree *target;
+            JobSystem::Handle job;
+            std::vector<std::pair<glm::uvec3, Octree::Node>> leaves;
+            size_t committed = 0;
+        };
+        std::deque<SceneChunk> sceneChunks;  //in insert order, later shapes overwrite earlier ones
+        size_t committedChunks = 0;
+
+        Benchmark *benchmark = nullptr;
+        CameraPath *recording = nullptr;    //session being captured by the record key
+        double recordStart = 0.0;
+
+        void queueShape(Octree *target, glm::ivec3 min, glm::ivec3 max, uint32_t material, std::function<bool(glm::ivec3)> solid);
+        bool commitScene(double budgetMs);
+        void timeQueries(const core::RendererConfig &config);
+
+        GLFWwindow *window;
+        Renderer *renderer;
+
+        FPCamera *camera;
+        Octree *octree;
+        Octree *prop;
+        InstanceScene *instances;
+        JobSystem *jobs;
+        MaterialPool *materialPool;
+        Interface *interface;
+
+        bool ui_active = true;
 };
\ No newline at end of file